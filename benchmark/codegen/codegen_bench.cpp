@@ -0,0 +1,98 @@
+#include "CodeGen.h"
+#include "Parser.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <chrono>
+#include <cstdlib>
+#include <string>
+
+/// @brief Builds `stmts` top-level statements mixing every statement kind.
+static std::string GenerateMixed(size_t stmts) {
+    static const char *lines[] = {
+        "a = (1 + b) * 3 - c / d + a;\n",
+        "if (b) { int e = a + 1; b = e * 2; } else b = 20;\n",
+        "{ int f = 4, g = 5; c = f * g - (a + b) / 2; }\n",
+        "d = a + b + c + d + 1 + 2 + 3;\n",
+    };
+    std::string src = "int a = 0, b = 2, c, d = 2;\n";
+    for (size_t i = 0; i < stmts; i++) {
+        src += lines[i % 4];
+    }
+    return src;
+}
+
+/// @brief Builds `stmts` statements whose expressions and conditions are mostly constant.
+static std::string GenerateConstants(size_t stmts) {
+    static const char *lines[] = {
+        "a = (1 + 2) * 3 - 8 / 2 + b;\n",
+        "if (2 * 3 - 6) { a = a + 1; b = a * 2; } else b = (4 + 4) * (2 - 1);\n",
+        "b = b * (60 * 60 * 24) + (1 + 2 + 3 + 4);\n",
+        "if (1) { a = a - (10 / 5); }\n",
+    };
+    std::string src = "int a = 0, b = 2;\n";
+    for (size_t i = 0; i < stmts; i++) {
+        src += lines[i % 4];
+    }
+    return src;
+}
+
+/// @brief Builds a single expression of `length` operators, i.e. an AST `length` levels deep.
+static std::string GenerateChain(size_t length) {
+    std::string src = "int a = 1;\na";
+    for (size_t i = 0; i < length; i++) {
+        src += " + a";
+    }
+    return src + ";\n";
+}
+
+/// @brief Builds `depth` if-statements, each nested in the then-block of the previous one.
+static std::string GenerateNestedIfs(size_t depth) {
+    std::string src = "int a = 1;\n";
+    for (size_t i = 0; i < depth; i++) {
+        src += "if (a) {\n";
+    }
+    src += "a = a + 1;\n";
+    for (size_t i = 0; i < depth; i++) {
+        src += "} else a = 2;\n";
+    }
+    return src;
+}
+
+/// @brief Parses `src`, then prints the AST size and the time spent generating IR for it.
+static void GenerateAndReport(const char *name, const std::string &src, bool shareExprs = false,
+                              bool directSSA = false) {
+    llvm::SourceMgr mgr;
+    Diagnostics diager(mgr);
+    mgr.AddNewSourceBuffer(llvm::MemoryBuffer::getMemBuffer(src, "bench"), llvm::SMLoc());
+
+    ASTContext astContext;
+    Lexer lexer(mgr, diager);
+    Sema sema(diager, astContext);
+    sema.SetExprSharing(shareExprs);
+    Parser parser(lexer, sema);
+    Program *program = parser.ParserProgram();
+
+    auto start = std::chrono::steady_clock::now();
+    CodeGen codeGen;
+    codeGen.SetDirectSSA(directSSA);
+    codeGen.VisitProgram(program);
+    std::chrono::duration<double> secs = std::chrono::steady_clock::now() - start;
+
+    size_t insts = codeGen.GetModule()->getInstructionCount();
+    llvm::outs() << name << ": " << src.size() << " bytes, AST "
+                 << astContext.GetBytesAllocated() << " bytes, " << insts << " instructions, "
+                 << llvm::format("%.3f", secs.count()) << " s\n";
+}
+
+int main(int argc, char *argv[]) {
+    size_t stmts = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    size_t depth = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000;
+    GenerateAndReport("mixed", GenerateMixed(stmts));
+    GenerateAndReport("mixed, shared exprs", GenerateMixed(stmts), true);
+    GenerateAndReport("mixed, direct SSA", GenerateMixed(stmts), false, true);
+    GenerateAndReport("constants", GenerateConstants(stmts));
+    GenerateAndReport("chain", GenerateChain(depth));
+    GenerateAndReport("nested-if", GenerateNestedIfs(depth));
+    GenerateAndReport("nested-if, direct SSA", GenerateNestedIfs(depth), false, true);
+    return 0;
+}
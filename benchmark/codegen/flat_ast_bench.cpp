@@ -0,0 +1,117 @@
+#include "ASTWalker.h"
+#include "CodeGen.h"
+#include "FlatAST.h"
+#include "Parser.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <chrono>
+#include <cstdlib>
+#include <string>
+
+/// @brief Builds `stmts` top-level statements mixing every statement kind.
+static std::string GenerateMixed(size_t stmts) {
+    static const char *lines[] = {
+        "a = (1 + b) * 3 - c / d + a;\n",
+        "if (b) { int e = a + 1; b = e * 2; } else b = 20;\n",
+        "{ int f = 4, g = 5; c = f * g - (a + b) / 2; }\n",
+        "d = a + b + c + d + 1 + 2 + 3;\n",
+    };
+    std::string src = "int a = 0, b = 2, c, d = 2;\n";
+    for (size_t i = 0; i < stmts; i++) {
+        src += lines[i % 4];
+    }
+    return src;
+}
+
+/// @brief Pointer-AST traversal that does as little as possible per node.
+class NodeCounter : public ASTWalker<NodeCounter> {
+  public:
+    size_t nodes = 0;
+    long sum     = 0;
+
+    void PostVisit(ASTNode *node) {
+        nodes++;
+        if (auto numberExpr = llvm::dyn_cast<NumberExpr>(node)) {
+            sum += numberExpr->value;
+        }
+    }
+};
+
+static double Seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static std::string PrintModule(llvm::Module *module) {
+    std::string text;
+    llvm::raw_string_ostream os(text);
+    module->print(os, nullptr);
+    return text;
+}
+
+int main(int argc, char *argv[]) {
+    size_t stmts    = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    std::string src = GenerateMixed(stmts);
+
+    llvm::SourceMgr mgr;
+    Diagnostics diager(mgr);
+    mgr.AddNewSourceBuffer(llvm::MemoryBuffer::getMemBuffer(src, "bench"), llvm::SMLoc());
+    ASTContext astContext;
+    Lexer lexer(mgr, diager);
+    Sema sema(diager, astContext);
+    Parser parser(lexer, sema);
+    Program *program = parser.ParserProgram();
+
+    auto start = std::chrono::steady_clock::now();
+    FlatAST flat(program, mgr.getMemoryBuffer(mgr.getMainFileID())->getBuffer(),
+                 astContext.GetTypes());
+    double flattenSecs = Seconds(start);
+    llvm::outs() << stmts << " statements, " << flat.GetNodeCount() << " nodes; flatten "
+                 << llvm::format("%.3f", flattenSecs) << " s\n";
+    llvm::outs() << "memory: pointer " << astContext.GetBytesAllocated() << " bytes, flat "
+                 << flat.GetBytesAllocated() << " bytes\n";
+
+    // Bare traversal: visit every node and read one field.
+    double pointerWalk = 1e9, flatScan = 1e9;
+    NodeCounter counter;
+    long flatSum = 0;
+    for (int i = 0; i < 5; i++) {
+        counter = NodeCounter();
+        start   = std::chrono::steady_clock::now();
+        for (ASTNode *stmt : program->stmts) {
+            counter.Walk(stmt);
+        }
+        pointerWalk = std::min(pointerWalk, Seconds(start));
+
+        flatSum = 0;
+        start   = std::chrono::steady_clock::now();
+        for (FlatAST::NodeId id = 0; id < flat.GetNodeCount(); id++) {
+            if (flat.GetKind(id) == ASTNode::ND_NumberExpr) {
+                flatSum += flat.GetData(id);
+            }
+        }
+        flatScan = std::min(flatScan, Seconds(start));
+    }
+    llvm::outs() << "traversal: pointer walk " << llvm::format("%.4f", pointerWalk)
+                 << " s, flat scan " << llvm::format("%.4f", flatScan) << " s"
+                 << (counter.sum == flatSum ? "" : " (MISMATCH)") << "\n";
+
+    // CodeGen over both layouts.
+    start = std::chrono::steady_clock::now();
+    CodeGen pointerGen(program);
+    double pointerGenSecs = Seconds(start);
+
+    start = std::chrono::steady_clock::now();
+    CodeGen flatGen;
+    flatGen.BeginMain();
+    for (FlatAST::NodeId stmt : flat.GetStmts()) {
+        flatGen.EmitStmt(flat, stmt);
+    }
+    flatGen.FinishMain();
+    double flatGenSecs = Seconds(start);
+
+    bool same = PrintModule(pointerGen.GetModule()) == PrintModule(flatGen.GetModule());
+    llvm::outs() << "codegen: pointer " << llvm::format("%.3f", pointerGenSecs) << " s, flat "
+                 << llvm::format("%.3f", flatGenSecs) << " s" << (same ? "" : " (IR DIFFERS)")
+                 << "\n";
+    return 0;
+}
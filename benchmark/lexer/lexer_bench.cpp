@@ -0,0 +1,84 @@
+#include "Lexer.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <chrono>
+#include <cstdlib>
+#include <string>
+
+/// Hand-written style: short names, shallow indentation.
+static const char *compactLines[] = {
+    "int counter_value = 123456, other_value = 42;\n",
+    "if (counter_value) {\n        other_value = other_value * 3 + counter_value / 7;\n",
+    "        counter_value = (1 + other_value) * 3 - counter_value / 2;\n    }\n",
+    "    else\n        other_value = 20;\n\n",
+};
+
+/// Machine-generated style: long mangled names, deep indentation, wide constants.
+static const char *wideLines[] = {
+    "                                int generated_temporary_value_for_block_number_one = "
+    "100000000000001;\n",
+    "                                if (generated_temporary_value_for_block_number_one) {\n",
+    "                                        generated_temporary_value_for_block_number_one = "
+    "generated_temporary_value_for_block_number_one * 300000000000003;\n",
+    "                                }\n\n\n",
+};
+
+/// Identifier-heavy: mostly keywords and short names, which exercises keyword classification.
+static const char *identifierLines[] = {
+    "int alpha, beta, gamma, delta, epsilon, zeta, eta, theta, iota, kappa, lambda;\n",
+    "if (alpha) if (beta) if (gamma) alpha = beta; else beta = gamma; else gamma = delta;\n",
+    "int in, el, els, elsewhere, integer, i, e, ifx, xif, intx;\n",
+    "if (kappa) { lambda = iota; } else { iota = theta; } eta = zeta; epsilon = eta;\n",
+};
+
+/// @brief Builds a translation unit of roughly `bytes` bytes by repeating `lines`.
+static std::string GenerateSource(const char *lines[4], size_t bytes) {
+    std::string src;
+    src.reserve(bytes + 256);
+    for (size_t i = 0; src.size() < bytes; i++) {
+        src += lines[i % 4];
+    }
+    return src;
+}
+
+/// @brief Lexes `src` to Eof `iters` times and returns the best throughput in MB/s.
+static double LexThroughput(const std::string &src, int iters, size_t &tokenCount) {
+    double best = 0;
+    for (int i = 0; i < iters; i++) {
+        llvm::SourceMgr mgr;
+        Diagnostics diager(mgr);
+        mgr.AddNewSourceBuffer(llvm::MemoryBuffer::getMemBuffer(src, "bench"), llvm::SMLoc());
+        Lexer lexer(mgr, diager);
+
+        Token tok;
+        tokenCount = 0;
+        auto start = std::chrono::steady_clock::now();
+        do {
+            lexer.NextToken(tok);
+            tokenCount++;
+        } while (tok.tokenTy != TokenType::Eof);
+        std::chrono::duration<double> secs = std::chrono::steady_clock::now() - start;
+
+        double mbps = src.size() / secs.count() / (1024.0 * 1024.0);
+        best        = mbps > best ? mbps : best;
+    }
+    return best;
+}
+
+int main(int argc, char *argv[]) {
+    size_t megabytes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 16;
+    struct {
+        const char *name;
+        const char **lines;
+    } profiles[] = {
+        {"compact", compactLines}, {"wide", wideLines}, {"identifiers", identifierLines}};
+
+    for (auto &profile : profiles) {
+        std::string src = GenerateSource(profile.lines, megabytes * 1024 * 1024);
+        size_t tokens   = 0;
+        double mbps     = LexThroughput(src, 5, tokens);
+        llvm::outs() << profile.name << ": " << src.size() << " bytes, " << tokens << " tokens, "
+                     << llvm::format("%.1f", mbps) << " MB/s\n";
+    }
+    return 0;
+}
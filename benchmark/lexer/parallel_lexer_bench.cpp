@@ -0,0 +1,49 @@
+#include "Lexer.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <chrono>
+#include <cstdlib>
+#include <string>
+
+/// @brief Builds a generated translation unit of roughly `bytes` bytes.
+static std::string GenerateSource(size_t bytes) {
+    std::string src;
+    src.reserve(bytes + 256);
+    for (size_t i = 0; src.size() < bytes; i++) {
+        src += "int generated_value_" + std::to_string(i % 1000) + " = ";
+        src += std::to_string(i) + ";\n";
+        src += "if (generated_value_0) {\n    generated_value_1 = (1 + generated_value_2) * 3;\n";
+        src += "} else\n    generated_value_3 = generated_value_4 / 7 - 20;\n";
+    }
+    return src;
+}
+
+int main(int argc, char *argv[]) {
+    size_t megabytes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100;
+    std::string src  = GenerateSource(megabytes * 1024 * 1024);
+
+    llvm::SourceMgr mgr;
+    Diagnostics diager(mgr);
+    mgr.AddNewSourceBuffer(llvm::MemoryBuffer::getMemBuffer(src, "bench"), llvm::SMLoc());
+
+    for (unsigned threads : {1u, 2u, 4u, 8u}) {
+        double best   = 1e30;
+        size_t tokens = 0;
+        for (int i = 0; i < 3; i++) {
+            Lexer lexer(mgr, diager);
+            lexer.SetThreadCount(threads);
+            std::vector<Token> tokenVec;
+
+            auto start = std::chrono::steady_clock::now();
+            lexer.LexAll(tokenVec);
+            std::chrono::duration<double> secs = std::chrono::steady_clock::now() - start;
+
+            tokens = tokenVec.size();
+            best   = secs.count() < best ? secs.count() : best;
+        }
+        llvm::outs() << threads << " thread(s): " << src.size() << " bytes, " << tokens
+                     << " tokens, " << llvm::format("%.3f", best) << " s, "
+                     << llvm::format("%.1f", src.size() / best / (1024.0 * 1024.0)) << " MB/s\n";
+    }
+    return 0;
+}
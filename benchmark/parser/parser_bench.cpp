@@ -0,0 +1,100 @@
+#include "Parser.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+/// Heap allocations made through operator new since the program started.
+static size_t allocCount = 0;
+static size_t allocBytes = 0;
+
+void *operator new(size_t size) {
+    allocCount++;
+    allocBytes += size;
+    if (void *ptr = std::malloc(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+/// @brief Builds a program of `stmts` top-level statements mixing every statement kind.
+static std::string GenerateMixed(size_t stmts) {
+    static const char *lines[] = {
+        "a = (1 + b) * 3 - c / d + a;\n",
+        "if (b) { int e = a + 1; b = e * 2; } else b = 20;\n",
+        "{ int f = 4, g = 5; c = f * g - (a + b) / 2; }\n",
+        "d = a + b + c + d + 1 + 2 + 3;\n",
+    };
+    std::string src = "int a = 0, b = 2, c, d = 2;\n";
+    for (size_t i = 0; i < stmts; i++) {
+        src += lines[i % 4];
+    }
+    return src;
+}
+
+/// @brief Builds `stmts` statements that are each a chain of 64 binary operators.
+static std::string GenerateChains(size_t stmts) {
+    std::string chain = "a = b";
+    for (int i = 0; i < 16; i++) {
+        chain += " + 1 * c - d / 2";
+    }
+    chain += ";\n";
+
+    std::string src = "int a = 0, b = 2, c = 3, d = 4;\n";
+    for (size_t i = 0; i < stmts; i++) {
+        src += chain;
+    }
+    return src;
+}
+
+/// @brief Builds one expression nested `depth` parentheses deep.
+static std::string GenerateNested(size_t depth) {
+    return "int a = 1;\n" + std::string(depth, '(') + "a" + std::string(depth, ')') + ";\n";
+}
+
+/// @brief Parses `src`, then prints parse time, heap allocations and the time to free the AST.
+static void ParseAndReport(const char *name, const std::string &src) {
+    llvm::SourceMgr mgr;
+    Diagnostics diager(mgr);
+    mgr.AddNewSourceBuffer(llvm::MemoryBuffer::getMemBuffer(src, "bench"), llvm::SMLoc());
+
+    auto astContext = std::make_unique<ASTContext>();
+    Lexer lexer(mgr, diager);
+    Sema sema(diager, *astContext);
+    Parser parser(lexer, sema);
+
+    size_t countBefore = allocCount;
+    size_t bytesBefore = allocBytes;
+    auto start         = std::chrono::steady_clock::now();
+    parser.ParserProgram();
+    std::chrono::duration<double> parseSecs = std::chrono::steady_clock::now() - start;
+    size_t allocs                           = allocCount - countBefore;
+    size_t bytes                            = allocBytes - bytesBefore;
+
+    start = std::chrono::steady_clock::now();
+    astContext.reset();
+    std::chrono::duration<double> freeSecs = std::chrono::steady_clock::now() - start;
+
+    llvm::outs() << name << ": " << src.size() << " bytes, "
+                 << llvm::format("%.3f", parseSecs.count()) << " s, " << allocs
+                 << " allocations (" << bytes << " bytes); free: "
+                 << llvm::format("%.3f", freeSecs.count()) << " s\n";
+}
+
+int main(int argc, char *argv[]) {
+    size_t stmts = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    ParseAndReport("mixed", GenerateMixed(stmts));
+    ParseAndReport("chains", GenerateChains(stmts / 8));
+    ParseAndReport("nested", GenerateNested(argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100));
+    return 0;
+}
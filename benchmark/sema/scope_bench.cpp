@@ -0,0 +1,74 @@
+#include "Scope.h"
+#include "TypeContext.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+/// Variables declared in every scope.
+static constexpr int VARS_PER_SCOPE = 8;
+
+static double Seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/// @brief Opens `depth` nested scopes declaring `VARS_PER_SCOPE` variables each, then prints the
+/// cost of looking up a variable of the outermost and of the innermost scope, and of unwinding.
+static void Measure(int depth, size_t lookups) {
+    IdentifierTable identifiers;
+    std::vector<IdentId> ids;
+    for (int d = 0; d < depth; d++) {
+        for (int v = 0; v < VARS_PER_SCOPE; v++) {
+            ids.push_back(identifiers.Intern("v" + std::to_string(d) + "_" + std::to_string(v)));
+        }
+    }
+
+    Scope scope;
+    TypeContext types;
+    auto start = std::chrono::steady_clock::now();
+    for (int d = 0; d < depth; d++) {
+        scope.EnterScope();
+        for (int v = 0; v < VARS_PER_SCOPE; v++) {
+            IdentId id = ids[d * VARS_PER_SCOPE + v];
+            scope.AddSymbol(id, identifiers.GetName(id), SymbolKind::LocalVariable,
+                            types.GetIntTy());
+        }
+    }
+    double declareSecs = Seconds(start);
+
+    size_t found = 0;
+    start        = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < lookups; i++) {
+        found += scope.FindVarSymbol(ids[i % VARS_PER_SCOPE]) != nullptr;
+    }
+    double outerSecs = Seconds(start);
+
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < lookups; i++) {
+        found += scope.FindVarSymbol(ids[ids.size() - 1 - i % VARS_PER_SCOPE]) != nullptr;
+    }
+    double innerSecs = Seconds(start);
+
+    start = std::chrono::steady_clock::now();
+    for (int d = 0; d < depth; d++) {
+        scope.ExitScope();
+    }
+    double exitSecs = Seconds(start);
+
+    llvm::outs() << "depth " << depth << ": outer lookup "
+                 << llvm::format("%.1f", outerSecs / lookups * 1e9) << " ns, inner lookup "
+                 << llvm::format("%.1f", innerSecs / lookups * 1e9) << " ns, declare "
+                 << llvm::format("%.1f", declareSecs / ids.size() * 1e9) << " ns/symbol, exit "
+                 << llvm::format("%.1f", exitSecs / depth * 1e9) << " ns/scope"
+                 << (found == 2 * lookups ? "" : " (LOOKUP FAILED)") << "\n";
+}
+
+int main(int argc, char *argv[]) {
+    size_t lookups = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    for (int depth : {1, 16, 256, 4096}) {
+        Measure(depth, lookups);
+    }
+    return 0;
+}
@@ -1,4 +1,4 @@
 #include "include/Ast.h"
 
-Program::Program(std::vector<std::shared_ptr<ASTNode>> stmts) : stmts(stmts) {
+Program::Program(llvm::ArrayRef<ASTNode *> stmts) : stmts(stmts) {
 }
\ No newline at end of file
@@ -0,0 +1,65 @@
+#include "include/Backend.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/MC/TargetRegistry.h"
+#include "llvm/Support/TargetSelect.h"
+#if LLVM_VERSION_MAJOR >= 17
+#include "llvm/TargetParser/Host.h"
+#else
+#include "llvm/Support/Host.h"
+#endif
+
+Backend::CodeGenLevel Backend::GetCodeGenLevel(unsigned optLevel) {
+    assert(optLevel <= 3 && "no such optimization level");
+#if LLVM_VERSION_MAJOR >= 18
+    static const CodeGenLevel LEVELS[] = {CodeGenLevel::None, CodeGenLevel::Less,
+                                          CodeGenLevel::Default, CodeGenLevel::Aggressive};
+#else
+    static const CodeGenLevel LEVELS[] = {llvm::CodeGenOpt::None, llvm::CodeGenOpt::Less,
+                                          llvm::CodeGenOpt::Default, llvm::CodeGenOpt::Aggressive};
+#endif
+    return LEVELS[optLevel];
+}
+
+std::unique_ptr<Backend> Backend::CreateForHost(unsigned optLevel, std::string &error) {
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+
+    std::string triple         = llvm::sys::getDefaultTargetTriple();
+    const llvm::Target *target = llvm::TargetRegistry::lookupTarget(triple, error);
+    if (!target) {
+        return nullptr;
+    }
+    llvm::TargetOptions options;
+    llvm::TargetMachine *targetMachine =
+        target->createTargetMachine(triple, llvm::sys::getHostCPUName(), "", options,
+                                    llvm::Reloc::PIC_, {}, GetCodeGenLevel(optLevel));
+    if (!targetMachine) {
+        error = "no target machine for " + triple;
+        return nullptr;
+    }
+    return std::unique_ptr<Backend>(
+        new Backend(std::unique_ptr<llvm::TargetMachine>(targetMachine)));
+}
+
+void Backend::ConfigureModule(llvm::Module &module) {
+    module.setTargetTriple(targetMachine->getTargetTriple().str());
+    module.setDataLayout(targetMachine->createDataLayout());
+}
+
+bool Backend::Emit(llvm::Module &module, FileKind kind, llvm::raw_pwrite_stream &os) {
+#if LLVM_VERSION_MAJOR >= 18
+    llvm::CodeGenFileType fileType = kind == FileKind::Object ? llvm::CodeGenFileType::ObjectFile
+                                                              : llvm::CodeGenFileType::AssemblyFile;
+#else
+    llvm::CodeGenFileType fileType =
+        kind == FileKind::Object ? llvm::CGFT_ObjectFile : llvm::CGFT_AssemblyFile;
+#endif
+    llvm::legacy::PassManager passManager;
+    // addPassesToEmitFile returns true when the target can not emit this kind of file.
+    if (targetMachine->addPassesToEmitFile(passManager, os, nullptr, fileType)) {
+        return false;
+    }
+    passManager.run(module);
+    return true;
+}
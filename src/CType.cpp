@@ -1,9 +1,35 @@
 #include "include/CType.h"
 
-CType::CType(int size, int align, CTypeKind kind) : size(size), align(align), kind(kind) {
+CType::CType(CTypeKind kind, uint64_t size, unsigned align, CType *elementTy, uint64_t arraySize)
+    : size(size), arraySize(arraySize), elementTy(elementTy), align(align), kind(kind) {
 }
 
-CType *CType::getIntTy() {
-    static CType type(4, 4, CTypeKind::Int);
-    return &type;
-}
\ No newline at end of file
+std::string CType::GetName() const {
+    switch (kind) {
+    case CTypeKind::Char:
+        return "char";
+    case CTypeKind::UChar:
+        return "unsigned char";
+    case CTypeKind::Short:
+        return "short";
+    case CTypeKind::UShort:
+        return "unsigned short";
+    case CTypeKind::Int:
+        return "int";
+    case CTypeKind::UInt:
+        return "unsigned int";
+    case CTypeKind::Long:
+        return "long";
+    case CTypeKind::ULong:
+        return "unsigned long";
+    case CTypeKind::LongLong:
+        return "long long";
+    case CTypeKind::ULongLong:
+        return "unsigned long long";
+    case CTypeKind::Pointer:
+        return elementTy->GetName() + " *";
+    case CTypeKind::Array:
+        return elementTy->GetName() + " [" + std::to_string(arraySize) + "]";
+    }
+    return "";
+}
@@ -1,147 +1,509 @@
 #include "include/CodeGen.h"
+#include "llvm/IR/CFG.h"
 #include "llvm/IR/Verifier.h"
 
 using namespace llvm;
 
-CodeGen::CodeGen(std::shared_ptr<Program> program) {
-    llvmModule = std::make_shared<Module>("Literal Expr", llvmContext);
-    VisitProgram(program.get());
+namespace {
+/// @brief Returns true if a statement of `kind` leaves a value for `FinishMain` to print
+/// @details Expression statements and declaration lists do. A block or an if-statement does not,
+/// whatever its last statement is.
+bool HasValue(ASTNode::Nodekind kind) {
+    return kind != ASTNode::ND_BlockStmts && kind != ASTNode::ND_IfStmt;
+}
+
+/// @brief Returns the type of the value `stmt` leaves behind, which for a declaration list is that
+/// of its last node
+CType *GetValueType(ASTNode *stmt) {
+    if (auto declStmts = dyn_cast<DeclStmts>(stmt); declStmts && !declStmts->nodeVec.empty()) {
+        return declStmts->nodeVec.back()->cType;
+    }
+    return stmt->cType;
+}
+
+/// @brief Same as above for a statement of a flattened AST
+CType *GetValueType(const FlatAST &ast, FlatAST::NodeId stmt) {
+    if (ast.GetKind(stmt) == ASTNode::ND_DeclStmts && !ast.GetChildren(stmt).empty()) {
+        return ast.GetType(ast.GetChildren(stmt).back());
+    }
+    return ast.GetType(stmt);
+}
+
+/// @brief Returns the printf format for a value of integer type `cType` after promotion
+const char *GetPrintfFormat(CType *cType) {
+    switch (cType->GetKind()) {
+    case CTypeKind::UInt:
+        return "lastVal: %u\n";
+    case CTypeKind::Long:
+        return "lastVal: %ld\n";
+    case CTypeKind::ULong:
+        return "lastVal: %lu\n";
+    case CTypeKind::LongLong:
+        return "lastVal: %lld\n";
+    case CTypeKind::ULongLong:
+        return "lastVal: %llu\n";
+    default:
+        return "lastVal: %d\n";
+    }
+}
+} // namespace
+
+CodeGen::CodeGen() {
+    llvmModule = std::make_unique<Module>("Literal Expr", llvmContext);
+}
+
+CodeGen::CodeGen(llvm::LLVMContext &context) : ownedContext(nullptr), llvmContext(context) {
+    llvmModule = std::make_unique<Module>("Literal Expr", llvmContext);
+}
+
+CodeGen::CodeGen(Program *program) : CodeGen() {
+    VisitProgram(program);
 }
 
 llvm::Value *CodeGen::VisitProgram(Program *program) {
+    BeginMain();
+    for (ASTNode *stmt : program->stmts) {
+        EmitStmt(stmt);
+    }
+    FinishMain();
+    return nullptr;
+}
+
+void CodeGen::BeginMain(llvm::StringRef name) {
+    assert(!(directSSA && globalVars) && "global variables are not built in SSA form");
+    if (!llvmModule) {
+        llvmModule = std::make_unique<Module>("Literal Expr", llvmContext);
+    }
+    moduleGlobals.clear();
+
     FunctionType *printfFuncTy = FunctionType::get(
         irBuilder.getInt32Ty(), {llvm::PointerType::get(irBuilder.getInt8Ty(), 0)}, true);
-    Function *printfFunc = Function::Create(
-        printfFuncTy, GlobalValue::LinkageTypes::ExternalLinkage, "printf", llvmModule.get());
+    printfFunc = Function::Create(printfFuncTy, GlobalValue::LinkageTypes::ExternalLinkage,
+                                  "printf", llvmModule.get());
 
     FunctionType *mainFuncTy = FunctionType::get(irBuilder.getInt32Ty(), false);
     Function *mainFunc       = Function::Create(
-        mainFuncTy, GlobalValue::LinkageTypes::ExternalLinkage, "main", llvmModule.get());
+        mainFuncTy, GlobalValue::LinkageTypes::ExternalLinkage, name, llvmModule.get());
     BasicBlock *entryBB = BasicBlock::Create(llvmContext, "entry", mainFunc);
+    // Allocas are inserted before this placeholder, so they stay ahead of all code in the entry
+    // block, in declaration order.
+    allocaInsertPt      = new BitCastInst(UndefValue::get(irBuilder.getInt32Ty()),
+                                          irBuilder.getInt32Ty(), "allocapt", entryBB);
+    allocaBuilder.SetInsertPoint(allocaInsertPt);
     irBuilder.SetInsertPoint(entryBB);
     currFunc = mainFunc;
+    lastVal  = nullptr;
+    lastType = nullptr;
+}
 
-    llvm::Value *lastVal;
-    for (std::shared_ptr<ASTNode> &stmt : program->stmts) {
-        lastVal = stmt->AcceptVisitor(this);
+void CodeGen::EmitStmt(ASTNode *stmt) {
+    if (!ReuseSharedValue(stmt)) {
+        Walk(stmt);
     }
+    llvm::Value *value = valueStack.pop_back_val();
+    lastVal            = HasValue(stmt->nodeKind) ? value : nullptr;
+    lastType           = GetValueType(stmt);
+}
+
+void CodeGen::FinishMain() {
     if (lastVal) {
-        irBuilder.CreateCall(printfFunc, {irBuilder.CreateGlobalString("lastVal: %d\n"), lastVal});
-    } else {
+        const char *format = "lastVal: %d\n";
+        if (lastType && lastVal->getType()->isIntegerTy()) {
+            // Variadic arguments narrower than int are passed as int.
+            format = GetPrintfFormat(lastType);
+            if (lastType->GetSize() < 4) {
+                lastVal = irBuilder.CreateIntCast(lastVal, irBuilder.getInt32Ty(),
+                                                  lastType->IsSigned());
+            }
+        }
+        irBuilder.CreateCall(printfFunc, {irBuilder.CreateGlobalString(format), lastVal});
+    } else if (!globalVars) {
+        // The REPL shows nothing for a statement without a value.
         irBuilder.CreateCall(printfFunc,
                              {irBuilder.CreateGlobalString("last inst is not expr.\n")});
     }
 
     irBuilder.CreateRet(irBuilder.getInt32(0));
+    allocaInsertPt->eraseFromParent();
+    allocaInsertPt = nullptr;
 
-    verifyFunction(*mainFunc);
-    llvmModule->print(llvm::outs(), nullptr);
-    return nullptr;
+    verifyFunction(*currFunc);
+}
+
+void CodeGen::EmitStmt(const FlatAST &ast, FlatAST::NodeId stmt) {
+    // Same traversal as ASTWalker::Walk, reading the children out of the flat columns.
+    struct Frame {
+        FlatAST::NodeId id;
+        unsigned nextChild;
+    };
+    llvm::SmallVector<Frame, 32> worklist;
+    if (varAddrs.size() < ast.GetSlotCount()) {
+        varAddrs.resize(ast.GetSlotCount());
+    }
+    auto preVisit = [&](FlatAST::NodeId id) {
+        if (ast.GetKind(id) == ASTNode::ND_IfStmt) {
+            EmitIfBegin(ast.GetChildren(id)[2] != FlatAST::NO_NODE);
+        }
+        worklist.push_back({id, 0});
+    };
+
+    preVisit(stmt);
+    while (!worklist.empty()) {
+        Frame &frame                             = worklist.back();
+        FlatAST::NodeId id                       = frame.id;
+        ASTNode::Nodekind kind                   = ast.GetKind(id);
+        llvm::ArrayRef<FlatAST::NodeId> children = ast.GetChildren(id);
+        if (frame.nextChild < children.size()) {
+            unsigned idx          = frame.nextChild++;
+            FlatAST::NodeId child = children[idx];
+            if (child == FlatAST::NO_NODE) {
+                continue;
+            }
+            if (kind == ASTNode::ND_IfStmt) {
+                EmitIfBranch(idx);
+            } else if (kind == ASTNode::ND_AssignExpr && idx == 0) {
+                continue;
+            }
+            preVisit(child);
+            continue;
+        }
+
+        worklist.pop_back();
+        switch (kind) {
+        case ASTNode::ND_DeclStmts:
+        case ASTNode::ND_BlockStmts:
+            CollapseValues(children.size());
+            break;
+        case ASTNode::ND_VariableDecl:
+            EmitVariableDecl(ast.GetType(id), ast.GetData(id), ast.GetSpelling(id));
+            break;
+        case ASTNode::ND_IfStmt:
+            EmitIfEnd();
+            break;
+        case ASTNode::ND_BinaryExpr:
+            EmitBinaryExpr(static_cast<OpCode>(ast.GetData(id)), ast.GetType(children[0]),
+                           ast.GetType(children[1]), ast.GetType(id));
+            break;
+        case ASTNode::ND_NumberExpr:
+            EmitNumberExpr(ast.GetData(id), ast.GetType(id));
+            break;
+        case ASTNode::ND_VariableAssessExpr:
+            EmitVariableAccess(ast.GetData(id), ast.GetSpelling(id));
+            break;
+        case ASTNode::ND_AssignExpr:
+            EmitAssign(ast.GetData(id), ast.GetSpelling(id), ast.GetType(children[1]));
+            break;
+        }
+    }
+    llvm::Value *value = valueStack.pop_back_val();
+    lastVal            = HasValue(ast.GetKind(stmt)) ? value : nullptr;
+    lastType           = GetValueType(ast, stmt);
+}
+
+void CodeGen::PreVisit(ASTNode *node) {
+    if (auto ifStmt = llvm::dyn_cast<IfStmt>(node)) {
+        EmitIfBegin(ifStmt->elseStmt != nullptr);
+    }
+}
+
+bool CodeGen::InVisit(ASTNode *node, unsigned childIdx) {
+    if (node->nodeKind == ASTNode::ND_IfStmt) {
+        EmitIfBranch(childIdx);
+    } else if (node->nodeKind == ASTNode::ND_AssignExpr && childIdx == 0) {
+        // The left side is an address, not a value; EmitAssign finds it through the symbol.
+        return false;
+    }
+    return !ReuseSharedValue(GetChild(node, childIdx));
+}
+
+void CodeGen::PostVisit(ASTNode *node) {
+    Visit(node);
+    if (node->isShared) {
+        sharedValues[node] = {irBuilder.GetInsertBlock(), valueStack.back()};
+    }
+}
+
+bool CodeGen::ReuseSharedValue(ASTNode *node) {
+    if (!node->isShared) {
+        return false;
+    }
+    auto it = sharedValues.find(node);
+    if (it == sharedValues.end() || it->second.first != irBuilder.GetInsertBlock()) {
+        return false;
+    }
+    valueStack.push_back(it->second.second);
+    return true;
+}
+
+void CodeGen::VisitDeclStmts(DeclStmts *declStmts) {
+    CollapseValues(declStmts->nodeVec.size());
+}
+
+void CodeGen::VisitBlockStmts(BlockStmts *blockStmts) {
+    CollapseValues(blockStmts->nodeVec.size());
+}
+
+void CodeGen::VisitVariableDecl(VariableDecl *variableDecl) {
+    EmitVariableDecl(variableDecl->cType, variableDecl->symbol->GetSlot(),
+                     variableDecl->token.GetText());
+}
+
+void CodeGen::VisitIfStmt(IfStmt *) {
+    EmitIfEnd();
+}
+
+void CodeGen::VisitBinaryExpr(BinaryExpr *binaryExpr) {
+    EmitBinaryExpr(binaryExpr->op, binaryExpr->leftExpr->cType, binaryExpr->rightExpr->cType,
+                   binaryExpr->cType);
 }
 
-llvm::Value *CodeGen::VisitDeclStmts(DeclStmts *declStmts) {
-    llvm::Value *lastVal = nullptr;
-    for (auto node : declStmts->nodeVec) {
-        lastVal = node->AcceptVisitor(this);
+void CodeGen::VisitNumberExpr(NumberExpr *numberExpr) {
+    EmitNumberExpr(numberExpr->value, numberExpr->cType);
+}
+
+void CodeGen::VisitVariableAssessExpr(VariableAssessExpr *variableAssessExpr) {
+    EmitVariableAccess(variableAssessExpr->symbol->GetSlot(), variableAssessExpr->token.GetText());
+}
+
+void CodeGen::VisitAssignExpr(AssignExpr *assignExpr) {
+    EmitAssign(assignExpr->symbol->GetSlot(), assignExpr->token.GetText(),
+               assignExpr->rightExpr->cType);
+}
+
+void CodeGen::CollapseValues(size_t count) {
+    if (count == 0) {
+        valueStack.push_back(nullptr);
+        return;
+    }
+    llvm::Value *lastVal = valueStack.back();
+    valueStack.truncate(valueStack.size() - count);
+    valueStack.push_back(lastVal);
+}
+
+void CodeGen::EmitIfBegin(bool hasElse) {
+    llvm::BasicBlock *condBB = llvm::BasicBlock::Create(llvmContext, "cond", currFunc);
+    llvm::BasicBlock *thenBB = llvm::BasicBlock::Create(llvmContext, "then", currFunc);
+    llvm::BasicBlock *elseBB = nullptr;
+    if (hasElse) {
+        elseBB = llvm::BasicBlock::Create(llvmContext, "else", currFunc);
     }
-    return lastVal;
+    llvm::BasicBlock *lastBB = llvm::BasicBlock::Create(llvmContext, "last", currFunc);
+    irBuilder.CreateBr(condBB);
+    irBuilder.SetInsertPoint(condBB);
+    ifStack.push_back({thenBB, elseBB, lastBB});
 }
 
-llvm::Value *CodeGen::VisitBlockStmts(BlockStmts *blockStmts) {
-    llvm::Value *lastVal = nullptr;
-    for (auto node : blockStmts->nodeVec) {
-        lastVal = node->AcceptVisitor(this);
+void CodeGen::EmitIfBranch(unsigned childIdx) {
+    IfBlocks &blocks = ifStack.back();
+    if (childIdx == 1) { ///< condition done, then-statement next
+        llvm::Value *val     = valueStack.pop_back_val();
+        llvm::Value *condVal = irBuilder.CreateICmpNE(val, ConstantInt::get(val->getType(), 0));
+        irBuilder.CreateCondBr(condVal, blocks.thenBB,
+                               blocks.elseBB ? blocks.elseBB : blocks.lastBB);
+        irBuilder.SetInsertPoint(blocks.thenBB);
+    } else if (childIdx == 2) { ///< then-statement done, else-statement next
+        valueStack.pop_back();
+        irBuilder.CreateBr(blocks.lastBB);
+        irBuilder.SetInsertPoint(blocks.elseBB);
     }
-    return lastVal;
 }
 
-llvm::Value *CodeGen::VisitBinaryExpr(BinaryExpr *binaryExpr) {
-    llvm::Value *left  = binaryExpr->leftExpr->AcceptVisitor(this);
-    llvm::Value *right = binaryExpr->rightExpr->AcceptVisitor(this);
+void CodeGen::EmitIfEnd() {
+    IfBlocks blocks = ifStack.pop_back_val();
+    valueStack.pop_back();
+    irBuilder.CreateBr(blocks.lastBB);
+    irBuilder.SetInsertPoint(blocks.lastBB);
+    valueStack.push_back(nullptr);
+}
+
+void CodeGen::EmitBinaryExpr(OpCode op, CType *leftTy, CType *rightTy, CType *resultTy) {
+    llvm::Value *right = EmitConversion(valueStack.pop_back_val(), rightTy, resultTy);
+    llvm::Value *left  = EmitConversion(valueStack.pop_back_val(), leftTy, resultTy);
 
-    switch (binaryExpr->op) {
+    // Signed overflow is undefined, unsigned arithmetic wraps.
+    bool isSigned      = resultTy->IsSigned();
+    llvm::Value *value = nullptr;
+    switch (op) {
     case OpCode::Add:
-        return irBuilder.CreateNSWAdd(left, right);
+        value = irBuilder.CreateAdd(left, right, "", false, isSigned);
         break;
     case OpCode::Sub:
-        return irBuilder.CreateNSWSub(left, right);
+        value = irBuilder.CreateSub(left, right, "", false, isSigned);
         break;
     case OpCode::Mul:
-        return irBuilder.CreateNSWMul(left, right);
+        value = irBuilder.CreateMul(left, right, "", false, isSigned);
         break;
     case OpCode::Div:
-        return irBuilder.CreateSDiv(left, right);
+        value = isSigned ? irBuilder.CreateSDiv(left, right) : irBuilder.CreateUDiv(left, right);
         break;
     default:
         break;
     }
-    return nullptr;
+    valueStack.push_back(value);
 }
 
-llvm::Value *CodeGen::VisitNumberExpr(NumberExpr *numberExpr) {
-    return irBuilder.getInt32(numberExpr->token.value);
+void CodeGen::EmitNumberExpr(int64_t value, CType *cType) {
+    valueStack.push_back(llvm::ConstantInt::get(ConvertType(cType), value, cType->IsSigned()));
 }
 
-llvm::Value *CodeGen::VisitVariableDecl(VariableDecl *variableDecl) {
-    llvm::Type *ty = nullptr;
-    if (variableDecl->cType == CType::getIntTy()) {
-        ty = irBuilder.getInt32Ty();
+void CodeGen::EmitVariableDecl(CType *cType, unsigned slot, llvm::StringRef name) {
+    llvm::Type *ty = ConvertType(cType);
+    if (slot >= varAddrs.size()) {
+        varAddrs.resize(slot + 1);
+    }
+    // A declaration produces no value in any mode; an initializer is an assignment of its own.
+    if (directSSA) {
+        // Until the first write the variable is undefined.
+        varAddrs[slot] = {nullptr, ty, cType};
+        WriteVariable(slot, irBuilder.GetInsertBlock(), llvm::UndefValue::get(ty));
+        valueStack.push_back(nullptr);
+        return;
     }
 
-    llvm::StringRef name(variableDecl->token.ptr, variableDecl->token.length);
-    llvm::Value *value = irBuilder.CreateAlloca(ty, nullptr, name);
-    varAddrTypeMap.insert({name, {value, ty}});
-    return value;
+    if (globalVars) {
+        // Zero-initialized like any C variable of static storage duration.
+        auto *global = new llvm::GlobalVariable(
+            *llvmModule, ty, false, llvm::GlobalValue::ExternalLinkage,
+            llvm::Constant::getNullValue(ty), GetGlobalName(slot, name));
+        global->setAlignment(llvm::Align(cType->GetAlign()));
+        varAddrs[slot]      = {nullptr, ty, cType};
+        moduleGlobals[slot] = global;
+        valueStack.push_back(nullptr);
+        return;
+    }
+
+    llvm::AllocaInst *value = allocaBuilder.CreateAlloca(ty, nullptr, name);
+    value->setAlignment(llvm::Align(cType->GetAlign()));
+    varAddrs[slot] = {value, ty, cType};
+    valueStack.push_back(nullptr);
 }
 
-llvm::Value *CodeGen::VisitIfStmt(IfStmt *ifStmt) {
-    llvm::BasicBlock *condBB = llvm::BasicBlock::Create(llvmContext, "cond", currFunc);
-    llvm::BasicBlock *thenBB = llvm::BasicBlock::Create(llvmContext, "then", currFunc);
-    llvm::BasicBlock *elseBB = nullptr;
-    if (ifStmt->elseStmt) {
-        elseBB = llvm::BasicBlock::Create(llvmContext, "else", currFunc);
+llvm::Value *CodeGen::GetVariableAddress(unsigned slot, llvm::StringRef name) {
+    const VarSlot &var = varAddrs[slot];
+    if (!globalVars) {
+        return var.addr;
     }
-    llvm::BasicBlock *lastBB = llvm::BasicBlock::Create(llvmContext, "last", currFunc);
-    irBuilder.CreateBr(condBB);
-    irBuilder.SetInsertPoint(condBB);
-    llvm::Value *val     = ifStmt->condExpr->AcceptVisitor(this);
-    llvm::Value *condVal = irBuilder.CreateICmpNE(val, irBuilder.getInt32(0));
-    if (ifStmt->elseStmt) {
-        irBuilder.CreateCondBr(condVal, thenBB, elseBB);
-        irBuilder.SetInsertPoint(thenBB);
-        ifStmt->thenStmt->AcceptVisitor(this);
-        irBuilder.CreateBr(lastBB);
-
-        irBuilder.SetInsertPoint(elseBB);
-        ifStmt->elseStmt->AcceptVisitor(this);
-        irBuilder.CreateBr(lastBB);
-    } else {
-        irBuilder.CreateCondBr(condVal, thenBB, lastBB);
-        irBuilder.SetInsertPoint(thenBB);
-        ifStmt->thenStmt->AcceptVisitor(this);
-        irBuilder.CreateBr(lastBB);
-    }
-    irBuilder.SetInsertPoint(lastBB);
-    return nullptr;
+    llvm::GlobalVariable *&global = moduleGlobals[slot];
+    if (!global) {
+        // Defined by the module of an earlier statement.
+        global = new llvm::GlobalVariable(*llvmModule, var.ty, false,
+                                          llvm::GlobalValue::ExternalLinkage, nullptr,
+                                          GetGlobalName(slot, name));
+        global->setAlignment(llvm::Align(var.cType->GetAlign()));
+    }
+    return global;
+}
+
+std::string CodeGen::GetGlobalName(unsigned slot, llvm::StringRef name) {
+    // Identifiers contain no '.', so the slot keeps shadowed variables of one name apart.
+    return (name + "." + llvm::Twine(slot)).str();
+}
+
+void CodeGen::EmitVariableAccess(unsigned slot, llvm::StringRef name) {
+    if (directSSA) {
+        valueStack.push_back(ReadVariable(slot, name, irBuilder.GetInsertBlock()));
+        return;
+    }
+    const VarSlot &var = varAddrs[slot];
+    valueStack.push_back(irBuilder.CreateAlignedLoad(var.ty, GetVariableAddress(slot, name),
+                                                     llvm::Align(var.cType->GetAlign()), name));
 }
 
-llvm::Value *CodeGen::VisitVariableAssessExpr(VariableAssessExpr *variableAssessExpr) {
-    llvm::StringRef name(variableAssessExpr->token.ptr, variableAssessExpr->token.length);
-    std::pair<llvm::Value *, llvm::Type *> pair = varAddrTypeMap[name];
-    llvm::Value *value                          = pair.first;
-    llvm::Type *ty                              = pair.second;
-    return irBuilder.CreateLoad(ty, value, name);
+void CodeGen::EmitAssign(unsigned slot, llvm::StringRef name, CType *valueTy) {
+    const VarSlot &var      = varAddrs[slot];
+    llvm::Value *rightValue = EmitConversion(valueStack.pop_back_val(), valueTy, var.cType);
+    if (directSSA) {
+        WriteVariable(slot, irBuilder.GetInsertBlock(), rightValue);
+        valueStack.push_back(rightValue);
+        return;
+    }
+    llvm::Align align = llvm::Align(var.cType->GetAlign());
+    llvm::Value *addr = GetVariableAddress(slot, name);
+    irBuilder.CreateAlignedStore(rightValue, addr, align);
+    valueStack.push_back(irBuilder.CreateAlignedLoad(var.ty, addr, align, name));
 }
 
-llvm::Value *CodeGen::VisitAssignExpr(AssignExpr *assignExpr) {
-    llvm::StringRef name(assignExpr->token.ptr, assignExpr->token.length);
-    auto leftExpr                               = assignExpr->leftExpr;
-    VariableAssessExpr *leftAccessExpr          = (VariableAssessExpr *)leftExpr.get();
-    std::pair<llvm::Value *, llvm::Type *> pair = varAddrTypeMap[name];
+llvm::Value *CodeGen::ReadVariable(unsigned slot, llvm::StringRef name, llvm::BasicBlock *block) {
+    auto it = currentDefs.find({slot, block});
+    if (it != currentDefs.end()) {
+        return it->second;
+    }
 
-    llvm::Type *leftValueTy    = pair.second;
-    llvm::Value *leftValueAddr = pair.first;
-    llvm::Value *rightValue    = assignExpr->rightExpr->AcceptVisitor(this);
-    irBuilder.CreateStore(rightValue, leftValueAddr);
-    return irBuilder.CreateLoad(leftValueTy, leftValueAddr, name);
-}
\ No newline at end of file
+    // Braun et al. look the value up recursively in the predecessors. Here the blocks are resolved
+    // depth-first with an explicit worklist instead, so a read after thousands of if-statements
+    // does not recurse thousands of frames deep. Every block on the way records its value, which
+    // makes later reads of the variable stop there.
+    //
+    // The CFG has no loops, and a block is only emitted into once all its predecessors have
+    // branched to it, so every predecessor's value can be known before the block's own. That
+    // spares the incomplete phis of unsealed blocks, and a phi is only created when the
+    // predecessors really disagree, so no trivial phi ever has to be removed.
+    llvm::SmallVector<llvm::BasicBlock *, 16> worklist = {block};
+    while (!worklist.empty()) {
+        llvm::BasicBlock *bb = worklist.back();
+        if (currentDefs.count({slot, bb})) {
+            worklist.pop_back();
+            continue;
+        }
+
+        bool predsKnown = true;
+        for (llvm::BasicBlock *pred : llvm::predecessors(bb)) {
+            if (!currentDefs.count({slot, pred})) {
+                worklist.push_back(pred);
+                predsKnown = false;
+            }
+        }
+        if (!predsKnown) {
+            continue;
+        }
+        worklist.pop_back();
+
+        llvm::Value *same = nullptr;
+        bool differ       = false;
+        unsigned numPreds = 0;
+        for (llvm::BasicBlock *pred : llvm::predecessors(bb)) {
+            llvm::Value *value = currentDefs.lookup({slot, pred});
+            differ             = differ || (same && value != same);
+            same               = value;
+            numPreds++;
+        }
+        assert(numPreds > 0 && "variable read before its declaration");
+        if (differ) {
+            llvm::IRBuilder<> phiBuilder(bb, bb->begin());
+            llvm::PHINode *phi = phiBuilder.CreatePHI(varAddrs[slot].ty, numPreds, name);
+            for (llvm::BasicBlock *pred : llvm::predecessors(bb)) {
+                phi->addIncoming(currentDefs.lookup({slot, pred}), pred);
+            }
+            same = phi;
+        }
+        WriteVariable(slot, bb, same);
+    }
+    return currentDefs.lookup({slot, block});
+}
+
+llvm::Type *CodeGen::ConvertType(CType *cType) {
+    if (llvm::Type *ty = llvmTypes.lookup(cType)) {
+        return ty;
+    }
+    llvm::Type *ty = nullptr;
+    switch (cType->GetKind()) {
+    case CTypeKind::Pointer:
+        ty = llvm::PointerType::get(ConvertType(cType->GetElementType()), 0);
+        break;
+    case CTypeKind::Array:
+        ty = llvm::ArrayType::get(ConvertType(cType->GetElementType()), cType->GetArraySize());
+        break;
+    default:
+        ty = irBuilder.getIntNTy(cType->GetSize() * 8);
+        break;
+    }
+    llvmTypes[cType] = ty;
+    return ty;
+}
+
+llvm::Value *CodeGen::EmitConversion(llvm::Value *value, CType *from, CType *to) {
+    if (from == to) {
+        return value;
+    }
+    return irBuilder.CreateIntCast(value, ConvertType(to), from->IsSigned());
+}
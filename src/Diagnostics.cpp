@@ -1,5 +1,7 @@
 #include "include/Diagnostics.h"
 #include "llvm/Support/Format.h"
+#include <algorithm>
+#include <cstring>
 
 static const char *DIAG_MSG[] = {
 #define DIAG(ID, KIND, MSG) MSG,
@@ -11,6 +13,41 @@ static llvm::SourceMgr::DiagKind DIAG_KIND[] = {
 #include "inc/Diagnostics.inc"
 };
 
+std::pair<unsigned, unsigned> Diagnostics::GetRowCol(llvm::SMLoc loc) {
+    const LineIndex &index = GetLineIndex(loc);
+    size_t offset          = loc.getPointer() - index.bufStart;
+    auto lineIt = std::upper_bound(index.lineStarts.begin(), index.lineStarts.end(), offset) - 1;
+    return {lineIt - index.lineStarts.begin() + 1, offset - *lineIt + 1};
+}
+
+const Diagnostics::LineIndex &Diagnostics::GetLineIndex(llvm::SMLoc loc) {
+    // Queries tend to stay in one buffer, so try the previous one before asking SourceMgr, which
+    // walks every buffer.
+    unsigned id = lastBufferId;
+    if (id == 0 || loc.getPointer() < mgr.getMemoryBuffer(id)->getBufferStart() ||
+        loc.getPointer() > mgr.getMemoryBuffer(id)->getBufferEnd()) {
+        id = mgr.FindBufferContainingLoc(loc);
+        assert(id != 0 && "location is not in any buffer of the SourceMgr");
+        lastBufferId = id;
+    }
+
+    if (lineIndexes.size() < id) {
+        lineIndexes.resize(id);
+    }
+    LineIndex &index = lineIndexes[id - 1];
+    if (!index.bufStart) {
+        llvm::StringRef buf = mgr.getMemoryBuffer(id)->getBuffer();
+        index.bufStart      = buf.begin();
+        index.lineStarts.push_back(0);
+        const char *ptr = buf.begin();
+        while (const void *nl = std::memchr(ptr, '\n', buf.end() - ptr)) {
+            ptr = static_cast<const char *>(nl) + 1;
+            index.lineStarts.push_back(ptr - buf.begin());
+        }
+    }
+    return index;
+}
+
 llvm::SourceMgr::DiagKind Diagnostics::GetDiagKind(unsigned int id) {
     return DIAG_KIND[id];
 }
@@ -0,0 +1,299 @@
+#include "include/FlatAST.h"
+#include "include/ASTWalker.h"
+#include "include/Scope.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+/// @brief Header of a saved `FlatAST`; the columns follow, each padded to `COLUMN_ALIGN` bytes.
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;  ///< `BYTE_ORDER_TAG` as written by the saving host
+    uint64_t sourceHash; ///< xxHash64 of the source the tree was parsed from
+    uint64_t sourceSize;
+    uint32_t nodeCount;
+    uint32_t childCount;
+    uint32_t stmtCount;
+    uint32_t slotCount; ///< Bound on the symbol slots in the data column
+};
+
+constexpr char AST_MAGIC[8]       = {'C', 'C', '_', 'A', 'S', 'T', '\0', '\0'};
+constexpr uint32_t AST_VERSION    = 5;
+constexpr uint32_t BYTE_ORDER_TAG = 0x01020304;
+constexpr size_t COLUMN_ALIGN     = 8;
+
+size_t PaddedSize(size_t bytes) {
+    return (bytes + COLUMN_ALIGN - 1) & ~(COLUMN_ALIGN - 1);
+}
+
+/// @brief Returns the size of a file holding `header`'s tree
+size_t FileSize(const FileHeader &header) {
+    size_t nodes = header.nodeCount;
+    return sizeof(FileHeader) + PaddedSize(nodes) * 2 + PaddedSize(nodes * sizeof(int64_t)) +
+           PaddedSize(nodes * sizeof(uint32_t)) + PaddedSize(nodes * sizeof(uint16_t)) +
+           PaddedSize((nodes + 1) * sizeof(uint32_t)) +
+           PaddedSize(header.childCount * sizeof(FlatAST::NodeId)) +
+           PaddedSize(header.stmtCount * sizeof(FlatAST::NodeId));
+}
+
+/// @brief Hands out consecutive columns of a mapped file
+class ColumnReader {
+  public:
+    ColumnReader(const char *pos) : pos(pos) {
+    }
+
+    template <typename T> llvm::ArrayRef<T> Read(size_t count) {
+        llvm::ArrayRef<T> column(reinterpret_cast<const T *>(pos), count);
+        pos += PaddedSize(count * sizeof(T));
+        return column;
+    }
+
+  private:
+    const char *pos;
+};
+
+/// @brief Returns how many children a node of `kind` has, or -1 when any number is fine
+int ExpectedChildCount(ASTNode::Nodekind kind) {
+    switch (kind) {
+    case ASTNode::ND_DeclStmts:
+    case ASTNode::ND_BlockStmts:
+        return -1;
+    case ASTNode::ND_IfStmt:
+        return 3;
+    case ASTNode::ND_BinaryExpr:
+    case ASTNode::ND_AssignExpr:
+        return 2;
+    default:
+        return 0;
+    }
+}
+
+template <typename T> void WriteColumn(llvm::raw_ostream &os, llvm::ArrayRef<T> column) {
+    size_t bytes = column.size() * sizeof(T);
+    os.write(reinterpret_cast<const char *>(column.data()), bytes);
+    os.write_zeros(PaddedSize(bytes) - bytes);
+}
+} // namespace
+
+/// @brief Appends nodes to a `FlatAST` in post-order while walking the pointer AST.
+class FlatASTBuilder : public ASTWalker<FlatASTBuilder> {
+  public:
+    FlatASTBuilder(FlatAST &ast) : ast(ast), columns(ast.storage) {
+    }
+
+    /// @brief Flattens the subtree under `stmt` and returns the id of its root
+    FlatAST::NodeId Build(ASTNode *stmt) {
+        Walk(stmt);
+        return ids.pop_back_val();
+    }
+
+  private:
+    friend class ASTWalker<FlatASTBuilder>;
+    void PostVisit(ASTNode *node) {
+        // The ids of the visited children are on top of `ids`, in order.
+        unsigned childCount = GetChildCount(node);
+        size_t present      = childCount;
+        if (auto ifStmt = llvm::dyn_cast<IfStmt>(node); ifStmt && !ifStmt->elseStmt) {
+            present--;
+        }
+        columns.children.insert(columns.children.end(), ids.end() - present, ids.end());
+        columns.children.resize(columns.children.size() + (childCount - present),
+                                FlatAST::NO_NODE);
+        ids.truncate(ids.size() - present);
+
+        int64_t data = 0;
+        if (auto numberExpr = llvm::dyn_cast<NumberExpr>(node)) {
+            data = numberExpr->value;
+        } else if (auto binaryExpr = llvm::dyn_cast<BinaryExpr>(node)) {
+            data = static_cast<int64_t>(binaryExpr->op);
+        } else if (Symbol *symbol = GetSymbol(node)) {
+            data          = static_cast<int64_t>(symbol->GetSlot());
+            ast.slotCount = std::max<size_t>(ast.slotCount, symbol->GetSlot() + 1);
+        }
+
+        ids.push_back(columns.kinds.size());
+        columns.kinds.push_back(node->nodeKind);
+        assert((!node->cType || node->cType->IsInteger()) && "derived types are not flattened");
+        columns.types.push_back(node->cType ? static_cast<uint8_t>(node->cType->GetKind())
+                                            : FlatAST::NO_TYPE);
+        columns.data.push_back(data);
+        columns.tokOffsets.push_back(node->token.ptr ? node->token.ptr - ast.bufStart : 0);
+        columns.tokLengths.push_back(node->token.length);
+        columns.childBegin.push_back(columns.children.size());
+    }
+
+    /// @brief Returns the variable `node` declares, reads or writes, or nullptr
+    static Symbol *GetSymbol(ASTNode *node) {
+        switch (node->nodeKind) {
+        case ASTNode::ND_VariableDecl:
+            return static_cast<VariableDecl *>(node)->symbol;
+        case ASTNode::ND_VariableAssessExpr:
+            return static_cast<VariableAssessExpr *>(node)->symbol;
+        case ASTNode::ND_AssignExpr:
+            return static_cast<AssignExpr *>(node)->symbol;
+        default:
+            return nullptr;
+        }
+    }
+
+  private:
+    FlatAST &ast;
+    FlatAST::Storage &columns;
+    llvm::SmallVector<FlatAST::NodeId, 32> ids;
+};
+
+FlatAST::FlatAST(const char *bufStart, TypeContext &typeContext)
+    : bufStart(bufStart), typeContext(typeContext), slotCount(0) {
+}
+
+FlatAST::FlatAST(Program *program, llvm::StringRef source, TypeContext &typeContext)
+    : FlatAST(source.data(), typeContext) {
+    storage.childBegin.push_back(0);
+    FlatASTBuilder builder(*this);
+    for (ASTNode *stmt : program->stmts) {
+        storage.stmts.push_back(builder.Build(stmt));
+    }
+    AttachStorage();
+}
+
+FlatAST::~FlatAST() = default;
+
+void FlatAST::AttachStorage() {
+    kinds      = storage.kinds;
+    types      = storage.types;
+    data       = storage.data;
+    tokOffsets = storage.tokOffsets;
+    tokLengths = storage.tokLengths;
+    childBegin = storage.childBegin;
+    children   = storage.children;
+    stmts      = storage.stmts;
+}
+
+CType *FlatAST::GetType(NodeId id) const {
+    if (types[id] == NO_TYPE) {
+        return nullptr;
+    }
+    return typeContext.GetIntegerType(static_cast<CTypeKind>(types[id]));
+}
+
+std::error_code FlatAST::Save(llvm::StringRef path, llvm::StringRef source) const {
+    FileHeader header = {};
+    std::memcpy(header.magic, AST_MAGIC, sizeof(AST_MAGIC));
+    header.version    = AST_VERSION;
+    header.byteOrder  = BYTE_ORDER_TAG;
+    header.sourceHash = llvm::xxHash64(source);
+    header.sourceSize = source.size();
+    header.nodeCount  = kinds.size();
+    header.childCount = children.size();
+    header.stmtCount  = stmts.size();
+    header.slotCount  = slotCount;
+
+    std::error_code ec;
+    llvm::raw_fd_ostream os(path, ec);
+    if (ec) {
+        return ec;
+    }
+    os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    WriteColumn(os, kinds);
+    WriteColumn(os, types);
+    WriteColumn(os, data);
+    WriteColumn(os, tokOffsets);
+    WriteColumn(os, tokLengths);
+    WriteColumn(os, childBegin);
+    WriteColumn(os, children);
+    WriteColumn(os, stmts);
+    os.close();
+    return os.error();
+}
+
+std::unique_ptr<FlatAST> FlatAST::Load(llvm::StringRef path, llvm::StringRef source,
+                                       TypeContext &typeContext) {
+    llvm::Expected<llvm::sys::fs::file_t> file = llvm::sys::fs::openNativeFileForRead(path);
+    if (!file) {
+        llvm::consumeError(file.takeError());
+        return nullptr;
+    }
+    uint64_t fileSize = 0;
+    std::error_code ec;
+    std::unique_ptr<llvm::sys::fs::mapped_file_region> mapping;
+    if (!llvm::sys::fs::file_size(path, fileSize) && fileSize >= sizeof(FileHeader)) {
+        mapping = std::make_unique<llvm::sys::fs::mapped_file_region>(
+            *file, llvm::sys::fs::mapped_file_region::readonly, fileSize, 0, ec);
+    }
+    llvm::sys::fs::closeFile(*file);
+    if (!mapping || ec) {
+        return nullptr;
+    }
+
+    FileHeader header;
+    std::memcpy(&header, mapping->const_data(), sizeof(header));
+    if (std::memcmp(header.magic, AST_MAGIC, sizeof(AST_MAGIC)) != 0 ||
+        header.version != AST_VERSION || header.byteOrder != BYTE_ORDER_TAG ||
+        header.sourceSize != source.size() || FileSize(header) != fileSize ||
+        header.sourceHash != llvm::xxHash64(source)) {
+        return nullptr;
+    }
+
+    std::unique_ptr<FlatAST> ast(new FlatAST(source.data(), typeContext));
+    ColumnReader reader(mapping->const_data() + sizeof(FileHeader));
+    ast->kinds      = reader.Read<uint8_t>(header.nodeCount);
+    ast->types      = reader.Read<uint8_t>(header.nodeCount);
+    ast->data       = reader.Read<int64_t>(header.nodeCount);
+    ast->tokOffsets = reader.Read<uint32_t>(header.nodeCount);
+    ast->tokLengths = reader.Read<uint16_t>(header.nodeCount);
+    ast->childBegin = reader.Read<uint32_t>(header.nodeCount + 1);
+    ast->children   = reader.Read<NodeId>(header.childCount);
+    ast->stmts      = reader.Read<NodeId>(header.stmtCount);
+    ast->slotCount  = header.slotCount;
+    ast->mapping    = std::move(mapping);
+    if (!ast->IsWellFormed(source.size())) {
+        return nullptr;
+    }
+    return ast;
+}
+
+bool FlatAST::IsWellFormed(size_t sourceSize) const {
+    if (childBegin[0] != 0 || childBegin.back() != children.size()) {
+        return false;
+    }
+    for (NodeId id = 0; id < kinds.size(); id++) {
+        if (kinds[id] > ASTNode::ND_AssignExpr || childBegin[id] > childBegin[id + 1] ||
+            tokOffsets[id] + size_t(tokLengths[id]) > sourceSize) {
+            return false;
+        }
+        if (HasSlot(GetKind(id)) && static_cast<uint64_t>(data[id]) >= slotCount) {
+            return false;
+        }
+        if (types[id] != NO_TYPE && types[id] > static_cast<uint8_t>(CTypeKind::ULongLong)) {
+            return false;
+        }
+        // CodeGen indexes the children of if-statements and binary and assignment expressions
+        // without checking, and lowers the type of every node that is not a statement list.
+        ASTNode::Nodekind kind              = GetKind(id);
+        llvm::ArrayRef<NodeId> nodeChildren = GetChildren(id);
+        int expected                        = ExpectedChildCount(kind);
+        if (expected >= 0 && nodeChildren.size() != static_cast<size_t>(expected)) {
+            return false;
+        }
+        if (expected != -1 && kind != ASTNode::ND_IfStmt && types[id] == NO_TYPE) {
+            return false;
+        }
+        // Post-order: children always come before their parent. Only a missing else-branch is
+        // left out.
+        for (size_t idx = 0; idx < nodeChildren.size(); idx++) {
+            NodeId child = nodeChildren[idx];
+            if (child == NO_NODE ? !(kind == ASTNode::ND_IfStmt && idx == 2) : child >= id) {
+                return false;
+            }
+        }
+    }
+    for (NodeId stmt : stmts) {
+        if (stmt >= kinds.size()) {
+            return false;
+        }
+    }
+    return true;
+}
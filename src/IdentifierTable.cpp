@@ -0,0 +1,57 @@
+#include "include/IdentifierTable.h"
+#include <cstring>
+
+namespace {
+/// Slot count of an empty table; must be a power of two.
+constexpr size_t INITIAL_SLOTS = 64;
+
+/// FNV-1a. Identifiers are short, so a byte loop the compiler can inline beats the general-purpose
+/// string hashes, which are out of line and tuned for long keys.
+inline uint64_t HashSpelling(llvm::StringRef name) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (char ch : name) {
+        hash = (hash ^ static_cast<unsigned char>(ch)) * 0x100000001b3ull;
+    }
+    return hash;
+}
+} // namespace
+
+IdentifierTable::IdentifierTable()
+    : slots(INITIAL_SLOTS, NO_IDENT), names{llvm::StringRef()}, hashes{0} {
+}
+
+IdentId IdentifierTable::Intern(llvm::StringRef name) {
+    uint64_t hash = HashSpelling(name);
+    size_t mask   = slots.size() - 1;
+    for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+        IdentId id = slots[slot];
+        if (id == NO_IDENT) {
+            char *spelling = nameStorage.Allocate<char>(name.size());
+            std::memcpy(spelling, name.data(), name.size());
+            id          = names.size();
+            slots[slot] = id;
+            names.push_back(llvm::StringRef(spelling, name.size()));
+            hashes.push_back(hash);
+            // Keep at least half of the slots free so probe sequences stay short.
+            if (names.size() * 2 > slots.size()) {
+                Grow();
+            }
+            return id;
+        }
+        if (hashes[id] == hash && names[id] == name) {
+            return id;
+        }
+    }
+}
+
+void IdentifierTable::Grow() {
+    slots.assign(slots.size() * 2, NO_IDENT);
+    size_t mask = slots.size() - 1;
+    for (IdentId id = 1; id < names.size(); id++) {
+        size_t slot = hashes[id] & mask;
+        while (slots[slot] != NO_IDENT) {
+            slot = (slot + 1) & mask;
+        }
+        slots[slot] = id;
+    }
+}
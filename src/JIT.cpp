@@ -0,0 +1,91 @@
+#include "include/JIT.h"
+#include "include/Backend.h"
+#include "include/Optimizer.h"
+#include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/Support/TargetSelect.h"
+
+std::unique_ptr<JIT> JIT::CreateForHost(unsigned optLevel, std::string &error) {
+    assert(optLevel <= 3 && "no such optimization level");
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+
+    llvm::Expected<llvm::orc::JITTargetMachineBuilder> builder =
+        llvm::orc::JITTargetMachineBuilder::detectHost();
+    if (!builder) {
+        error = llvm::toString(builder.takeError());
+        return nullptr;
+    }
+    builder->setCodeGenOptLevel(Backend::GetCodeGenLevel(optLevel));
+    llvm::Expected<std::unique_ptr<llvm::TargetMachine>> targetMachine =
+        builder->createTargetMachine();
+    if (!targetMachine) {
+        error = llvm::toString(targetMachine.takeError());
+        return nullptr;
+    }
+
+    llvm::Expected<std::unique_ptr<llvm::orc::LLJIT>> lljit =
+        llvm::orc::LLJITBuilder().setJITTargetMachineBuilder(std::move(*builder)).create();
+    if (!lljit) {
+        error = llvm::toString(lljit.takeError());
+        return nullptr;
+    }
+    char prefix = (*lljit)->getDataLayout().getGlobalPrefix();
+    llvm::Expected<std::unique_ptr<llvm::orc::DynamicLibrarySearchGenerator>> process =
+        llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(prefix);
+    if (!process) {
+        error = llvm::toString(process.takeError());
+        return nullptr;
+    }
+    (*lljit)->getMainJITDylib().addGenerator(std::move(*process));
+
+    return std::unique_ptr<JIT>(
+        new JIT(std::move(*lljit), std::move(*targetMachine), optLevel));
+}
+
+bool JIT::AddModule(std::unique_ptr<llvm::LLVMContext> context,
+                    std::unique_ptr<llvm::Module> module, std::string &error) {
+    return AddModule(llvm::orc::ThreadSafeModule(std::move(module), std::move(context)), error);
+}
+
+bool JIT::AddModule(std::unique_ptr<llvm::Module> module, std::string &error) {
+    return AddModule(llvm::orc::ThreadSafeModule(std::move(module), sharedContext), error);
+}
+
+bool JIT::AddModule(llvm::orc::ThreadSafeModule module, std::string &error) {
+    module.withModuleDo([&](llvm::Module &m) {
+        m.setTargetTriple(targetMachine->getTargetTriple().str());
+        m.setDataLayout(lljit->getDataLayout());
+        Optimizer(optLevel, targetMachine.get()).Run(m);
+    });
+    lastModule = lljit->getMainJITDylib().createResourceTracker();
+    if (llvm::Error err = lljit->addIRModule(lastModule, std::move(module))) {
+        error = llvm::toString(std::move(err));
+        return false;
+    }
+    return true;
+}
+
+bool JIT::Call(llvm::StringRef name, int &result, std::string &error) {
+    auto symbol = lljit->lookup(name);
+    if (!symbol) {
+        error = llvm::toString(symbol.takeError());
+        return false;
+    }
+#if LLVM_VERSION_MAJOR >= 15
+    auto *function = symbol->toPtr<int (*)()>();
+#else
+    auto *function = reinterpret_cast<int (*)()>(symbol->getAddress());
+#endif
+    result = function();
+    return true;
+}
+
+void JIT::RemoveLastModule() {
+    if (!lastModule) {
+        return;
+    }
+    // Nothing can be done about a failure here; the module's symbols merely stay defined.
+    llvm::consumeError(lastModule->remove());
+    lastModule = nullptr;
+}
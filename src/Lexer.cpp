@@ -1,4 +1,153 @@
 #include "include/Lexer.h"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+#if !defined(LEXER_DISABLE_SIMD) && defined(__AVX2__)
+#include <immintrin.h>
+#define LEXER_SIMD 1
+#elif !defined(LEXER_DISABLE_SIMD) && defined(__SSE2__)
+#include <emmintrin.h>
+#define LEXER_SIMD 1
+#endif
+
+namespace {
+struct Keyword {
+    const char *spelling;
+    unsigned length;
+    TokenType tokenTy;
+};
+
+constexpr Keyword KEYWORDS[] = {
+#define KEYWORD(SPELLING, TOKEN) {#SPELLING, sizeof(#SPELLING) - 1, TokenType::TOKEN},
+#include "inc/Keywords.inc"
+};
+constexpr unsigned KEYWORD_COUNT = sizeof(KEYWORDS) / sizeof(KEYWORDS[0]);
+
+/// Slot count of the keyword hash table; must be a power of two.
+constexpr unsigned KEYWORD_TABLE_SIZE = 128;
+
+/// Perfect hash over the spellings in Keywords.inc, built from the length and the first and last
+/// characters. Besides the current keywords it is also collision-free over the full C99 keyword
+/// set, so new keywords can be added to Keywords.inc without touching the lexer.
+constexpr unsigned KeywordHash(const char *ptr, unsigned length) {
+    return (length + static_cast<unsigned char>(ptr[0]) * 54u +
+            static_cast<unsigned char>(ptr[length - 1])) &
+           (KEYWORD_TABLE_SIZE - 1);
+}
+
+constexpr bool KeywordHashIsPerfect() {
+    for (unsigned i = 0; i < KEYWORD_COUNT; i++) {
+        for (unsigned j = i + 1; j < KEYWORD_COUNT; j++) {
+            if (KeywordHash(KEYWORDS[i].spelling, KEYWORDS[i].length) ==
+                KeywordHash(KEYWORDS[j].spelling, KEYWORDS[j].length)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+static_assert(KeywordHashIsPerfect(), "two keywords in Keywords.inc share a slot of KeywordHash");
+
+/// Maps a hash slot to its index in KEYWORDS, or -1 when no keyword hashes there.
+struct KeywordTable {
+    signed char slots[KEYWORD_TABLE_SIZE];
+};
+
+constexpr KeywordTable BuildKeywordTable() {
+    KeywordTable table{};
+    for (unsigned i = 0; i < KEYWORD_TABLE_SIZE; i++) {
+        table.slots[i] = -1;
+    }
+    for (unsigned i = 0; i < KEYWORD_COUNT; i++) {
+        table.slots[KeywordHash(KEYWORDS[i].spelling, KEYWORDS[i].length)] =
+            static_cast<signed char>(i);
+    }
+    return table;
+}
+constexpr KeywordTable KEYWORD_TABLE = BuildKeywordTable();
+} // namespace
+
+#ifdef LEXER_SIMD
+namespace {
+/// Thin wrappers over the SSE2/AVX2 intrinsics so the scanning loops below are written once.
+/// Each helper classifies one block of `BLOCK_SIZE` bytes and returns a bit mask with bit i set
+/// when byte i matches.
+#ifdef __AVX2__
+constexpr int BLOCK_SIZE      = 32;
+constexpr uint32_t BLOCK_MASK = 0xFFFFFFFFu;
+using Vec                     = __m256i;
+
+inline Vec Load(const char *p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+}
+inline Vec Splat(char c) {
+    return _mm256_set1_epi8(c);
+}
+inline Vec Eq(Vec a, Vec b) {
+    return _mm256_cmpeq_epi8(a, b);
+}
+inline Vec Gt(Vec a, Vec b) {
+    return _mm256_cmpgt_epi8(a, b);
+}
+inline Vec And(Vec a, Vec b) {
+    return _mm256_and_si256(a, b);
+}
+inline Vec Or(Vec a, Vec b) {
+    return _mm256_or_si256(a, b);
+}
+inline uint32_t MoveMask(Vec v) {
+    return static_cast<uint32_t>(_mm256_movemask_epi8(v));
+}
+#else
+constexpr int BLOCK_SIZE      = 16;
+constexpr uint32_t BLOCK_MASK = 0xFFFFu;
+using Vec                     = __m128i;
+
+inline Vec Load(const char *p) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+}
+inline Vec Splat(char c) {
+    return _mm_set1_epi8(c);
+}
+inline Vec Eq(Vec a, Vec b) {
+    return _mm_cmpeq_epi8(a, b);
+}
+inline Vec Gt(Vec a, Vec b) {
+    return _mm_cmpgt_epi8(a, b);
+}
+inline Vec And(Vec a, Vec b) {
+    return _mm_and_si128(a, b);
+}
+inline Vec Or(Vec a, Vec b) {
+    return _mm_or_si128(a, b);
+}
+inline uint32_t MoveMask(Vec v) {
+    return static_cast<uint32_t>(_mm_movemask_epi8(v));
+}
+#endif
+
+/// Runs shorter than this are scanned byte by byte before switching to block classification.
+constexpr int SCALAR_PREFIX = 8;
+
+/// Bytes in [lo, hi]. Both bounds are ASCII, so bytes >= 0x80 compare as negative and never match.
+inline Vec InRange(Vec v, char lo, char hi) {
+    return And(Gt(v, Splat(lo - 1)), Gt(Splat(hi + 1), v));
+}
+
+inline uint32_t WhiteSpaceMask(Vec v) {
+    return MoveMask(Or(Or(Eq(v, Splat(' ')), Eq(v, Splat('\r'))), Eq(v, Splat('\n'))));
+}
+
+inline uint32_t DigitMask(Vec v) {
+    return MoveMask(InRange(v, '0', '9'));
+}
+
+inline uint32_t LetterMask(Vec v) {
+    return MoveMask(Or(Or(InRange(v, 'a', 'z'), InRange(v, 'A', 'Z')), Eq(v, Splat('_'))));
+}
+} // namespace
+#endif
 
 llvm::StringRef Token::GetSpellingText(TokenType ty) {
     switch (ty) {
@@ -35,9 +184,10 @@ llvm::StringRef Token::GetSpellingText(TokenType ty) {
     case TokenType::Identifier:
         return "Identifier";
         break;
-    case TokenType::KW_int:
-        return "int";
-        break;
+#define KEYWORD(SPELLING, TOKEN)                                                                   \
+    case TokenType::TOKEN:                                                                         \
+        return #SPELLING;
+#include "inc/Keywords.inc"
     case TokenType::Eof:
         return "Eof";
         break;
@@ -47,47 +197,65 @@ llvm::StringRef Token::GetSpellingText(TokenType ty) {
     }
 }
 
-Lexer::Lexer(llvm::SourceMgr &mgr, Diagnostics &diag) : mgr(mgr), diager(diag) {
-    unsigned int id     = mgr.getMainFileID();
-    llvm::StringRef buf = mgr.getMemoryBuffer(id)->getBuffer();
+bool Token::GetValue(uint64_t &value) const {
+    llvm::StringRef digits = GetText().drop_back(GetSuffix().size());
+    // getAsInteger returns true on overflow, and never sees a sign here.
+    return !digits.getAsInteger(10, value);
+}
+
+llvm::StringRef Token::GetSuffix() const {
+    return GetText().drop_while([](char ch) { return ch >= '0' && ch <= '9'; });
+}
+
+std::pair<unsigned, unsigned> Token::GetRowCol(Diagnostics &diager) const {
+    return diager.GetRowCol(llvm::SMLoc::getFromPointer(ptr));
+}
+
+Lexer::Lexer(llvm::SourceMgr &mgr, Diagnostics &diag) : Lexer(mgr, diag, *new IdentifierTable()) {
+    ownIdentifiers.reset(identifiers);
+}
+
+Lexer::Lexer(llvm::SourceMgr &mgr, Diagnostics &diag, IdentifierTable &identifiers)
+    : Lexer(mgr, diag, identifiers, mgr.getMainFileID()) {
+}
+
+Lexer::Lexer(llvm::SourceMgr &mgr, Diagnostics &diag, IdentifierTable &identifiers,
+             unsigned bufferId)
+    : mgr(mgr), diager(diag), identifiers(&identifiers), threadCount(1), deferErrors(false),
+      hasError(false) {
+    llvm::StringRef buf = mgr.getMemoryBuffer(bufferId)->getBuffer();
     workPtr             = buf.begin();
     eofPtr              = buf.end();
-    workRowHeadPtr      = buf.begin();
-    workRow             = 1;
 }
 
-void Lexer::NextToken(Token &tok) {
-    while (IsWhiteSpace(*workPtr)) {
-        if (*workPtr == '\n') {
-            workRow++;
-            workRowHeadPtr = workPtr + 1;
-        }
-        workPtr++;
-    }
+Lexer::Lexer(const Lexer &parent, const char *begin, const char *end)
+    : mgr(parent.mgr), diager(parent.diager), identifiers(nullptr), workPtr(begin), eofPtr(end),
+      threadCount(1), deferErrors(true), hasError(false) {
+}
 
-    tok.row = workRow;
-    tok.col = workPtr - workRowHeadPtr + 1;
+void Lexer::NextToken(Token &tok) {
+    SkipWhiteSpace();
 
     if (workPtr >= eofPtr) {
-        tok.tokenTy = TokenType::Eof;
+        tok.setMember(TokenType::Eof, workPtr, 0);
         return;
     }
 
     const char *tokenStart = workPtr;
     if (IsDigit(*workPtr)) {
-        int number = 0;
-        while (IsDigit(*workPtr)) {
-            number = number * 10 + (*workPtr - '0');
-            workPtr++;
+        workPtr = ScanDigits(workPtr);
+        // A suffix such as "ul" belongs to the number; Sema checks it.
+        if (workPtr < eofPtr && IsLetter(*workPtr)) {
+            workPtr = ScanLetters(workPtr);
         }
-        tok.setMember(
-            TokenType::Number, tokenStart, workPtr - tokenStart, number, CType::getIntTy());
+        tok.setMember(TokenType::Number, tokenStart, TokenLength(tokenStart));
     } else if (IsLetter(*workPtr)) {
-        while (IsLetter(*workPtr)) {
-            workPtr++;
-        }
-        tok.setMember(TokenType::Identifier, tokenStart, workPtr - tokenStart);
+        workPtr = ScanLetters(workPtr);
+        tok.setMember(TokenType::Identifier, tokenStart, TokenLength(tokenStart));
         KeyWordHandle(tok);
+        if (tok.tokenTy == TokenType::Identifier && identifiers) {
+            tok.identId = identifiers->Intern(tok.GetText());
+        }
     } else {
         switch (*workPtr) {
         case '=': {
@@ -146,8 +314,13 @@ void Lexer::NextToken(Token &tok) {
             break;
         }
         default:
-            diager.Report(llvm::SMLoc::getFromPointer(workPtr), diag::error_unknown_char, workPtr);
-            tok.tokenTy = TokenType::Unknown;
+            if (deferErrors) {
+                hasError = true;
+            } else {
+                diager.Report(
+                    llvm::SMLoc::getFromPointer(workPtr), diag::error_unknown_char, workPtr);
+            }
+            tok.setMember(TokenType::Unknown, workPtr, 1);
             workPtr++;
             break;
         }
@@ -157,37 +330,181 @@ void Lexer::NextToken(Token &tok) {
 void Lexer::Run(Token &tok) {
     NextToken(tok);
     while (tok.tokenTy != TokenType::Eof) {
-        tok.Dump();
+        tok.Dump(diager);
         NextToken(tok);
     }
 }
 
-void Lexer::SaveState() {
-    state.eofPtr         = eofPtr;
-    state.workPtr        = workPtr;
-    state.workRow        = workRow;
-    state.workRowHeadPtr = workRowHeadPtr;
+Diagnostics &Lexer::GetDiagnostics() {
+    return diager;
+}
+
+void Lexer::SetThreadCount(unsigned count) {
+    threadCount = count > 0 ? count : 1;
 }
 
-void Lexer::RestoreState() {
-    eofPtr         = state.eofPtr;
-    workPtr        = state.workPtr;
-    workRow        = state.workRow;
-    workRowHeadPtr = state.workRowHeadPtr;
+bool Lexer::ShouldLexInParallel() const {
+    return threadCount > 1 && static_cast<size_t>(eofPtr - workPtr) >= PARALLEL_THRESHOLD;
 }
 
-Diagnostics &Lexer::GetDiagnostics() {
-    return diager;
+void Lexer::LexAll(std::vector<Token> &tokens) {
+    // Chunk i covers [cuts[i], cuts[i + 1]); every inner cut sits on a blank.
+    std::vector<const char *> cuts{workPtr};
+    size_t chunkSize = (eofPtr - workPtr) / threadCount;
+    for (unsigned i = 1; i < threadCount; i++) {
+        const char *cut = std::max(cuts.back(), workPtr + i * chunkSize);
+        while (cut < eofPtr && !IsWhiteSpace(*cut)) {
+            cut++;
+        }
+        cuts.push_back(cut);
+    }
+    cuts.push_back(eofPtr);
+
+    unsigned chunkCount = cuts.size() - 1;
+    std::vector<std::vector<Token>> chunkTokens(chunkCount);
+    std::vector<char> chunkOk(chunkCount);
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < chunkCount; i++) {
+        workers.emplace_back(
+            [&, i] { chunkOk[i] = LexChunk(cuts[i], cuts[i + 1], chunkTokens[i]); });
+    }
+    chunkOk[0] = LexChunk(cuts[0], cuts[1], chunkTokens[0]);
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+
+    size_t total = tokens.size();
+    for (auto &chunk : chunkTokens) {
+        total += chunk.size();
+    }
+    tokens.reserve(total + 1);
+    for (unsigned i = 0; i < chunkCount; i++) {
+        if (!chunkOk[i]) {
+            // Let the serial lexer reach the error and report it.
+            workPtr = cuts[i];
+            Token tok;
+            do {
+                NextToken(tok);
+                tokens.push_back(tok);
+            } while (tok.tokenTy != TokenType::Eof);
+            return;
+        }
+        for (Token &tok : chunkTokens[i]) {
+            if (tok.tokenTy == TokenType::Identifier) {
+                tok.identId = identifiers->Intern(tok.GetText());
+            }
+        }
+        tokens.insert(tokens.end(), chunkTokens[i].begin(), chunkTokens[i].end());
+        chunkTokens[i] = std::vector<Token>();
+    }
+
+    workPtr = eofPtr;
+    Token eof;
+    NextToken(eof);
+    tokens.push_back(eof);
+}
+
+bool Lexer::LexChunk(const char *begin, const char *end, std::vector<Token> &tokens) {
+    Lexer chunkLexer(*this, begin, end);
+
+    // Roughly one token per five bytes of typical source.
+    tokens.reserve((end - begin) / 5);
+    Token tok;
+    chunkLexer.NextToken(tok);
+    while (tok.tokenTy != TokenType::Eof && !chunkLexer.hasError) {
+        tokens.push_back(tok);
+        chunkLexer.NextToken(tok);
+    }
+    return !chunkLexer.hasError;
 }
 
 void Lexer::KeyWordHandle(Token &tok) {
-    if (llvm::StringRef(tok.ptr, tok.length) == "int") {
-        tok.tokenTy = TokenType::KW_int;
-    } else if (llvm::StringRef(tok.ptr, tok.length) == "if") {
-        tok.tokenTy = TokenType::KW_if;
-    } else if (llvm::StringRef(tok.ptr, tok.length) == "else") {
-        tok.tokenTy = TokenType::KW_else;
+    int slot = KEYWORD_TABLE.slots[KeywordHash(tok.ptr, tok.length)];
+    if (slot < 0) {
+        return;
+    }
+    const Keyword &keyword = KEYWORDS[slot];
+    if (keyword.length == static_cast<unsigned>(tok.length) &&
+        std::memcmp(keyword.spelling, tok.ptr, tok.length) == 0) {
+        tok.tokenTy = keyword.tokenTy;
+    }
+}
+
+void Lexer::SkipWhiteSpace() {
+#ifdef LEXER_SIMD
+    // Most gaps between tokens are a few bytes long, which is cheaper to step over than to
+    // classify a whole block for.
+    for (const char *prefixEnd = workPtr + SCALAR_PREFIX; workPtr < prefixEnd; workPtr++) {
+        if (workPtr >= eofPtr || !IsWhiteSpace(*workPtr)) {
+            return;
+        }
+    }
+    while (eofPtr - workPtr >= BLOCK_SIZE) {
+        uint32_t stop = ~WhiteSpaceMask(Load(workPtr)) & BLOCK_MASK;
+        if (stop) {
+            workPtr += __builtin_ctz(stop);
+            return;
+        }
+        workPtr += BLOCK_SIZE;
+    }
+#endif
+    while (workPtr < eofPtr && IsWhiteSpace(*workPtr)) {
+        workPtr++;
+    }
+}
+
+uint16_t Lexer::TokenLength(const char *tokenStart) {
+    if (workPtr - tokenStart > UINT16_MAX) {
+        if (deferErrors) {
+            hasError = true;
+            return UINT16_MAX;
+        }
+        diager.Report(
+            llvm::SMLoc::getFromPointer(tokenStart), diag::error_token_too_long, UINT16_MAX);
+    }
+    return static_cast<uint16_t>(workPtr - tokenStart);
+}
+
+const char *Lexer::ScanDigits(const char *ptr) {
+#ifdef LEXER_SIMD
+    for (const char *prefixEnd = ptr + SCALAR_PREFIX; ptr < prefixEnd; ptr++) {
+        if (ptr >= eofPtr || !IsDigit(*ptr)) {
+            return ptr;
+        }
+    }
+    while (eofPtr - ptr >= BLOCK_SIZE) {
+        uint32_t stop = ~DigitMask(Load(ptr)) & BLOCK_MASK;
+        if (stop) {
+            return ptr + __builtin_ctz(stop);
+        }
+        ptr += BLOCK_SIZE;
+    }
+#endif
+    while (ptr < eofPtr && IsDigit(*ptr)) {
+        ptr++;
+    }
+    return ptr;
+}
+
+const char *Lexer::ScanLetters(const char *ptr) {
+#ifdef LEXER_SIMD
+    for (const char *prefixEnd = ptr + SCALAR_PREFIX; ptr < prefixEnd; ptr++) {
+        if (ptr >= eofPtr || !IsLetter(*ptr)) {
+            return ptr;
+        }
+    }
+    while (eofPtr - ptr >= BLOCK_SIZE) {
+        uint32_t stop = ~LetterMask(Load(ptr)) & BLOCK_MASK;
+        if (stop) {
+            return ptr + __builtin_ctz(stop);
+        }
+        ptr += BLOCK_SIZE;
+    }
+#endif
+    while (ptr < eofPtr && IsLetter(*ptr)) {
+        ptr++;
     }
+    return ptr;
 }
 
 bool Lexer::IsWhiteSpace(char ch) {
@@ -0,0 +1,35 @@
+#include "include/Optimizer.h"
+#include "llvm/Passes/PassBuilder.h"
+#include "llvm/Passes/StandardInstrumentations.h"
+
+void Optimizer::Run(llvm::Module &module) {
+    if (level == 0) {
+        return;
+    }
+
+    llvm::LoopAnalysisManager lam;
+    llvm::FunctionAnalysisManager fam;
+    llvm::CGSCCAnalysisManager cgam;
+    llvm::ModuleAnalysisManager mam;
+
+    llvm::PassInstrumentationCallbacks pic;
+#if LLVM_VERSION_MAJOR >= 16
+    llvm::StandardInstrumentations si(module.getContext(), false);
+#else
+    llvm::StandardInstrumentations si(false);
+#endif
+    si.registerCallbacks(pic);
+
+    llvm::PassBuilder pb(targetMachine, llvm::PipelineTuningOptions(), {}, &pic);
+    pb.registerModuleAnalyses(mam);
+    pb.registerCGSCCAnalyses(cgam);
+    pb.registerFunctionAnalyses(fam);
+    pb.registerLoopAnalyses(lam);
+    pb.crossRegisterProxies(lam, fam, cgam, mam);
+
+    static const llvm::OptimizationLevel LEVELS[] = {
+        llvm::OptimizationLevel::O0, llvm::OptimizationLevel::O1, llvm::OptimizationLevel::O2,
+        llvm::OptimizationLevel::O3};
+    llvm::ModulePassManager mpm = pb.buildPerModuleDefaultPipeline(LEVELS[level]);
+    mpm.run(module, mam);
+}
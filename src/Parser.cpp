@@ -1,50 +1,130 @@
 #include "include/Parser.h"
 
-Parser::Parser(Lexer &lex, Sema &sema) : lexer(lex), sema(sema) {
+Parser::Parser(Lexer &lex, Sema &sema) : lexer(lex), tokenStream(lex), sema(sema) {
     Advance();
 }
 
+namespace {
+bool IsTypeSpecifier(TokenType tokTy) {
+    switch (tokTy) {
+    case TokenType::KW_char:
+    case TokenType::KW_short:
+    case TokenType::KW_int:
+    case TokenType::KW_long:
+    case TokenType::KW_signed:
+    case TokenType::KW_unsigned:
+        return true;
+    default:
+        return false;
+    }
+}
+} // namespace
+
 /// @brief  prog : stmt*
-std::shared_ptr<Program> Parser::ParserProgram() {
-    std::vector<std::shared_ptr<ASTNode>> stmts;
-    while (token.tokenTy != TokenType::Eof) {
-        auto stmt = Parser::ParserStmt();
-        if (stmt) {
+Program *Parser::ParserProgram() {
+    std::vector<ASTNode *> stmts;
+    while (!IsAtEof()) {
+        if (auto stmt = ParserTopLevelStmt()) {
             stmts.push_back(stmt);
         }
     }
-    auto program = std::make_shared<Program>(std::move(stmts));
-    return program;
+    ASTContext &context = sema.GetASTContext();
+    return context.Create<Program>(context.CopyArray<ASTNode *>(stmts));
+}
+
+ASTNode *Parser::ParserTopLevelStmt() {
+    return ParserStmt();
 }
 
 /// @brief stmt : decl-stmt | expr-stmt | null-stmt | if-stmt | block-stmt
-std::shared_ptr<ASTNode> Parser::ParserStmt() {
-    if (token.tokenTy == TokenType::Semi) { ///< null-stmt
-        Advance();
-        return nullptr;
-    } else if (token.tokenTy == TokenType::KW_int) { ///< decl-stmt
-        return ParserDeclStmt();
-    } else if (token.tokenTy == TokenType::KW_if) { ///< if-stmt
-        return ParserIfStmt();
-    } else if (token.tokenTy == TokenType::LeftBrace) { ///< block-stmt
-        return ParserBlockStmt();
-    } else { ///< expr-stmt
-        return ParserExprStmt();
+/// @details Block and if-statements nest arbitrarily deep, so they are parsed with an explicit
+/// stack of the ones still open rather than by recursion, in the manner of `ParserExpr`:
+/// block-stmt : "{" stmt* "}"
+/// if-stmt    : "if" "(" expr ")" stmt ("else" stmt)?
+ASTNode *Parser::ParserStmt() {
+    struct OpenStmt {
+        enum Kind { Block, Then, Else } kind;
+        ASTNode *condExpr; ///< Of an if-statement
+        ASTNode *thenStmt; ///< Of an if-statement in its else-branch
+        size_t firstStmt;  ///< Of a block, its first statement in `blockStmts`
+    };
+    llvm::SmallVector<OpenStmt, 16> open;
+    llvm::SmallVector<ASTNode *, 16> blockStmts; ///< Statements of all open blocks, in order
+
+    while (true) {
+        // Opens a block or if-statement, or parses a statement that contains no statements.
+        ASTNode *stmt = nullptr;
+        bool done     = false; ///< `stmt` is a complete statement
+        if (token.tokenTy == TokenType::LeftBrace) {
+            sema.EnterScope();
+            Consume(TokenType::LeftBrace);
+            open.push_back({OpenStmt::Block, nullptr, nullptr, blockStmts.size()});
+        } else if (token.tokenTy == TokenType::KW_if) {
+            Consume(TokenType::KW_if);
+            Consume(TokenType::LeftParent);
+            ASTNode *condExpr = ParserExpr();
+            Consume(TokenType::RightParent);
+            open.push_back({OpenStmt::Then, condExpr, nullptr, 0});
+        } else if (token.tokenTy == TokenType::Semi) { ///< null-stmt
+            Advance();
+            done = true;
+        } else if (IsTypeSpecifier(token.tokenTy)) {
+            stmt = ParserDeclStmt();
+            done = true;
+        } else {
+            stmt = ParserExprStmt();
+            done = true;
+        }
+
+        // Completes the open statements that are waiting for no more than what was just parsed.
+        while (!open.empty()) {
+            OpenStmt &top = open.back();
+            if (top.kind == OpenStmt::Block) {
+                if (done && stmt) {
+                    blockStmts.push_back(stmt);
+                }
+                done = false;
+                if (token.tokenTy != TokenType::RightBrace) {
+                    break;
+                }
+                Consume(TokenType::RightBrace);
+                sema.ExitScope();
+                stmt = sema.SemaBlockStmtNode(
+                    llvm::ArrayRef<ASTNode *>(blockStmts).drop_front(top.firstStmt));
+                blockStmts.truncate(top.firstStmt);
+            } else if (!done) {
+                break;
+            } else if (top.kind == OpenStmt::Then && token.tokenTy == TokenType::KW_else) {
+                Consume(TokenType::KW_else);
+                top.kind     = OpenStmt::Else;
+                top.thenStmt = stmt;
+                done         = false;
+                break;
+            } else if (top.kind == OpenStmt::Then) {
+                stmt = sema.SemaIfStmtNode(top.condExpr, stmt, nullptr);
+            } else {
+                stmt = sema.SemaIfStmtNode(top.condExpr, top.thenStmt, stmt);
+            }
+            open.pop_back();
+            done = true;
+        }
+        if (open.empty()) {
+            return stmt;
+        }
     }
 }
 
-/// @brief decl-stmt : "int" identifier ("=" expr)? ("," identifier ("=" expr)?)* ";"
-std::shared_ptr<ASTNode> Parser::ParserDeclStmt() {
-    Consume(TokenType::KW_int);
-    CType *cTy = CType::getIntTy();
+/// @brief decl-stmt : decl-spec identifier ("=" expr)? ("," identifier ("=" expr)?)* ";"
+ASTNode *Parser::ParserDeclStmt() {
+    CType *cTy = ParserDeclSpec();
 
-    auto declNode = std::make_shared<DeclStmts>();
+    llvm::SmallVector<ASTNode *, 4> nodeVec;
     // int a = 1, c = 2, d;
     while (token.tokenTy != TokenType::Semi) {
         Token variableToken = token;
         auto variableDecl   = sema.SemaVariableDeclNode(cTy, token);
-        declNode->nodeVec.push_back(variableDecl);
-        assert(Consume(TokenType::Identifier));
+        nodeVec.push_back(variableDecl);
+        Consume(TokenType::Identifier);
 
         if (token.tokenTy == TokenType::Equal) {
             Token tok = token;
@@ -52,7 +132,7 @@ std::shared_ptr<ASTNode> Parser::ParserDeclStmt() {
             auto left       = sema.SemaVariableAccessExprNode(variableToken);
             auto right      = ParserExpr();
             auto assignExpr = sema.SemaAssignExprNode(left, right, tok);
-            declNode->nodeVec.push_back(assignExpr);
+            nodeVec.push_back(assignExpr);
         }
 
         if (token.tokenTy == TokenType::Comma) {
@@ -60,126 +140,193 @@ std::shared_ptr<ASTNode> Parser::ParserDeclStmt() {
         }
     }
     Consume(TokenType::Semi);
-    return declNode;
+    return sema.SemaDeclStmtNode(nodeVec);
 }
 
-std::shared_ptr<ASTNode> Parser::ParserBlockStmt() {
-    sema.EnterScope();
-    Consume(TokenType::LeftBrace);
-    auto blockStmts = std::make_shared<BlockStmts>();
-    while (token.tokenTy != TokenType::RightBrace) {
-        blockStmts->nodeVec.push_back(ParserStmt());
+/// @brief decl-spec : ("char" | "short" | "int" | "long" | "signed" | "unsigned")+
+/// @details As in C, the specifiers may come in any order, e.g. "long unsigned long". Combinations
+/// that name no type, such as "short long" or "signed unsigned", are rejected.
+CType *Parser::ParserDeclSpec() {
+    // `signs` counts "signed" and "unsigned" alike.
+    unsigned chars = 0, shorts = 0, ints = 0, longs = 0, signs = 0;
+    bool isUnsigned = false;
+    while (IsTypeSpecifier(token.tokenTy)) {
+        switch (token.tokenTy) {
+        case TokenType::KW_char:
+            chars++;
+            break;
+        case TokenType::KW_short:
+            shorts++;
+            break;
+        case TokenType::KW_int:
+            ints++;
+            break;
+        case TokenType::KW_long:
+            longs++;
+            break;
+        case TokenType::KW_signed:
+            signs++;
+            break;
+        case TokenType::KW_unsigned:
+            signs++;
+            isUnsigned = true;
+            break;
+        default:
+            break;
+        }
+        bool valid = signs <= 1 && ints <= 1 && longs <= 2 &&
+                     chars + shorts + (longs > 0 ? 1 : 0) <= 1 && !(chars && ints);
+        if (!valid) {
+            GetDiagnostics().Report(llvm::SMLoc::getFromPointer(token.ptr),
+                                    diag::error_type_spec,
+                                    llvm::StringRef(token.ptr, token.length));
+        }
+        Advance();
     }
-    Consume(TokenType::RightBrace);
-    sema.ExitScope();
-    return blockStmts;
+
+    CTypeKind kind = CTypeKind::Int;
+    if (chars) {
+        kind = CTypeKind::Char;
+    } else if (shorts) {
+        kind = CTypeKind::Short;
+    } else if (longs == 1) {
+        kind = CTypeKind::Long;
+    } else if (longs == 2) {
+        kind = CTypeKind::LongLong;
+    }
+    TypeContext &types = sema.GetASTContext().GetTypes();
+    CType *cTy         = types.GetIntegerType(kind);
+    return isUnsigned ? types.GetUnsignedType(cTy) : cTy;
 }
 
 /// @brief expr-stmt : expr ";"
-std::shared_ptr<ASTNode> Parser::ParserExprStmt() {
+ASTNode *Parser::ParserExprStmt() {
     auto expr = ParserExpr();
     Consume(TokenType::Semi);
     return expr;
 }
 
-/// @brief if-stmt : "if" "(" expr ")" "{" stmt  "}" ("else" "{" stmt "}")?
-std::shared_ptr<ASTNode> Parser::ParserIfStmt() {
-    Consume(TokenType::KW_if);
-    Consume(TokenType::LeftParent);
-    auto condExpr = ParserExpr();
-    Consume(TokenType::RightParent);
-    auto thenStmt                     = ParserStmt();
-    std::shared_ptr<ASTNode> elseStmt = nullptr;
-    if (token.tokenTy == TokenType::KW_else) {
-        Consume(TokenType::KW_else);
-        elseStmt = ParserStmt();
+namespace {
+/// @brief One row of the binary operator table.
+struct BinaryOperator {
+    TokenType tokenTy;
+    int precedence;  ///< Higher binds tighter
+    bool rightAssoc; ///< `a = b = c` groups as `a = (b = c)`
+    bool isAssign;   ///< Built with `SemaAssignExprNode` instead of `SemaBinaryExprNode`
+    OpCode op;       ///< Only meaningful when `isAssign` is false
+};
+
+/// Every binary operator the expression parser knows about. Adding an operator to the grammar is
+/// a matter of adding a row here.
+constexpr BinaryOperator BINARY_OPERATORS[] = {
+    {TokenType::Equal, 1, true, true, OpCode::Add},
+    {TokenType::Plus, 2, false, false, OpCode::Add},
+    {TokenType::Minus, 2, false, false, OpCode::Sub},
+    {TokenType::Star, 3, false, false, OpCode::Mul},
+    {TokenType::Slash, 3, false, false, OpCode::Div},
+};
+
+/// Maps a TokenType to its row in BINARY_OPERATORS, or -1.
+struct OperatorIndex {
+    signed char rows[static_cast<int>(TokenType::Eof) + 1];
+};
+
+constexpr OperatorIndex BuildOperatorIndex() {
+    OperatorIndex index{};
+    for (auto &row : index.rows) {
+        row = -1;
     }
-    return sema.SemaIfStmtNode(condExpr, thenStmt, elseStmt);
+    for (unsigned i = 0; i < sizeof(BINARY_OPERATORS) / sizeof(BINARY_OPERATORS[0]); i++) {
+        index.rows[static_cast<int>(BINARY_OPERATORS[i].tokenTy)] = static_cast<signed char>(i);
+    }
+    return index;
+}
+constexpr OperatorIndex OPERATOR_INDEX = BuildOperatorIndex();
+
+const BinaryOperator *FindBinaryOperator(TokenType tokTy) {
+    int row = OPERATOR_INDEX.rows[static_cast<int>(tokTy)];
+    return row < 0 ? nullptr : &BINARY_OPERATORS[row];
 }
+} // namespace
 
 /// @brief expr        : assign-expr | add-expr
 ///        assign-expr : identifier ("=" expr)+
 ///        add-expr    : mult-expr ( ("+" | "_") mult-expr)*
-std::shared_ptr<ASTNode> Parser::ParserExpr() {
-    bool isAssignExpr = false;
-    lexer.SaveState();
-    if (token.tokenTy == TokenType::Identifier) {
-        Token tmp;
-        lexer.NextToken(tmp);
-        if (tmp.tokenTy == TokenType::Equal) {
-            isAssignExpr = true;
-        }
-    }
-    lexer.RestoreState();
+///        mult-expr   : primary-expr ( ("*" | "/") primary-expr)*
+/// @details Precedence climbing over BINARY_OPERATORS with explicit operand and operator stacks,
+/// so neither long operator chains nor deeply parenthesized input grow the native stack. An open
+/// parenthesis is kept on the operator stack as a null entry that nothing reduces across.
+ASTNode *Parser::ParserExpr() {
+    struct PendingOperator {
+        const BinaryOperator *info; ///< nullptr for "("
+        Token tok;
+    };
+    llvm::SmallVector<ASTNode *, 16> operands;
+    llvm::SmallVector<PendingOperator, 16> operators;
+    size_t openParens = 0;
 
-    if (isAssignExpr) {
-        return ParserAssignExpr();
-    }
-
-    auto left = ParserTerm();
-    // a + b + c + d...
-    while (token.tokenTy == TokenType::Plus || token.tokenTy == TokenType::Minus) {
-        OpCode op;
-        if (token.tokenTy == TokenType::Plus) {
-            op = OpCode::Add;
+    auto reduce = [&]() {
+        PendingOperator top = operators.pop_back_val();
+        ASTNode *right      = operands.pop_back_val();
+        ASTNode *left       = operands.pop_back_val();
+        if (top.info->isAssign) {
+            operands.push_back(sema.SemaAssignExprNode(left, right, top.tok));
         } else {
-            op = OpCode::Sub;
+            operands.push_back(sema.SemaBinaryExprNode(left, top.info->op, right, top.tok));
         }
-        Advance();
+    };
 
-        auto right   = ParserTerm();
-        auto binExpr = sema.SemaBinaryExprNode(left, op, right);
-        left         = binExpr;
-    }
-    return left;
-}
+    while (true) {
+        // An operand, possibly behind some open parentheses.
+        while (token.tokenTy == TokenType::LeftParent) {
+            operators.push_back({nullptr, token});
+            openParens++;
+            Advance();
+        }
+        operands.push_back(ParserPrimaryExpr());
 
-/// @brief assign-expr : identifier ("=" expr)+
-std::shared_ptr<ASTNode> Parser::ParserAssignExpr() {
-    IsExcept(TokenType::Identifier);
-    auto leftExpr = sema.SemaVariableAccessExprNode(token);
-    Advance();
-    Token tok = token;
-    Consume(TokenType::Equal);
-    return sema.SemaAssignExprNode(leftExpr, ParserExpr(), tok);
-}
+        // Close parentheses until the next binary operator or the end of the expression.
+        const BinaryOperator *info = FindBinaryOperator(token.tokenTy);
+        while (!info && openParens > 0) {
+            while (operators.back().info) {
+                reduce();
+            }
+            Consume(TokenType::RightParent);
+            operators.pop_back();
+            openParens--;
+            info = FindBinaryOperator(token.tokenTy);
+        }
+        if (!info) {
+            break;
+        }
 
-/// @brief term  : factor(("*" | "/") factor)*
-std::shared_ptr<ASTNode> Parser::ParserTerm() {
-    auto left = ParserFactor();
-    // a * b * c * d...
-    while (token.tokenTy == TokenType::Star || token.tokenTy == TokenType::Slash) {
-        OpCode op;
-        if (token.tokenTy == TokenType::Star) {
-            op = OpCode::Mul;
-        } else {
-            op = OpCode::Div;
+        while (!operators.empty() && operators.back().info &&
+               (operators.back().info->precedence > info->precedence ||
+                (operators.back().info->precedence == info->precedence && !info->rightAssoc))) {
+            reduce();
         }
+        operators.push_back({info, token});
         Advance();
-        auto right   = ParserFactor();
-        auto binExpr = sema.SemaBinaryExprNode(left, op, right);
-        left         = binExpr;
     }
-    return left;
+
+    while (!operators.empty()) {
+        reduce();
+    }
+    return operands.back();
 }
 
-/// @brief factor : identifier | number | "(" expr")"
-std::shared_ptr<ASTNode> Parser::ParserFactor() {
-    if (token.tokenTy == TokenType::LeftParent) {
-        Advance();
-        auto expr = ParserExpr();
-        assert(IsExcept(TokenType::RightParent));
-        Advance();
-        return expr;
-    } else if (token.tokenTy == TokenType::Identifier) {
-        auto factorExpr = sema.SemaVariableAccessExprNode(token);
+/// @brief primary-expr : identifier | number
+/// @details Parenthesized expressions are handled by `ParserExpr` itself.
+ASTNode *Parser::ParserPrimaryExpr() {
+    if (token.tokenTy == TokenType::Identifier) {
+        auto primaryExpr = sema.SemaVariableAccessExprNode(token);
         Advance();
-        return factorExpr;
+        return primaryExpr;
     } else {
         IsExcept(TokenType::Number);
-        auto factorExpr = sema.SemaNumberExprNode(token.cType, token);
+        auto primaryExpr = sema.SemaNumberExprNode(token);
         Advance();
-        return factorExpr;
+        return primaryExpr;
     }
 }
 
@@ -207,7 +354,7 @@ bool Parser::Consume(TokenType tokTy) {
 }
 
 void Parser::Advance() {
-    lexer.NextToken(token);
+    token = tokenStream.Next();
 }
 
 Diagnostics &Parser::GetDiagnostics() {
@@ -1,99 +1,113 @@
 #include "include/PrintVisitor.h"
 #include "llvm/Support/raw_ostream.h"
 
-PrintVisitor::PrintVisitor(std::shared_ptr<Program> program) {
-    VisitProgram(program.get());
+PrintVisitor::PrintVisitor(Program *program) {
+    VisitProgram(program);
 }
 
-llvm::Value *PrintVisitor::VisitProgram(Program *program) {
+void PrintVisitor::VisitProgram(Program *program) {
     llvm::outs() << "Program :\n--------------------\n\n";
-    for (std::shared_ptr<ASTNode> &stmt : program->stmts) {
-        stmt->AcceptVisitor(this);
+    for (ASTNode *stmt : program->stmts) {
+        Walk(stmt);
         llvm::outs() << "\n";
     }
     llvm::outs() << "\n-----------------------------\n";
-    return nullptr;
 }
 
-llvm::Value *PrintVisitor::VisitDeclStmts(DeclStmts *declStmts) {
-    for (auto node : declStmts->nodeVec) {
-        node->AcceptVisitor(this);
-        llvm::outs() << "\n";
-    }
-    return nullptr;
-}
-
-llvm::Value *PrintVisitor::VisitVariableDecl(VariableDecl *variableDecl) {
-    if (variableDecl->cType == CType::getIntTy()) {
-        llvm::outs() << "int "
-                     << llvm::StringRef(variableDecl->token.ptr, variableDecl->token.length) << ";";
+void PrintVisitor::PreVisit(ASTNode *node) {
+    switch (node->nodeKind) {
+    case ASTNode::ND_VariableDecl:
+        llvm::outs() << node->cType->GetName() << " "
+                     << llvm::StringRef(node->token.ptr, node->token.length) << ";";
+        break;
+    case ASTNode::ND_BlockStmts:
+        llvm::outs() << "{\n";
+        break;
+    case ASTNode::ND_IfStmt:
+        llvm::outs() << "if (";
+        break;
+    case ASTNode::ND_NumberExpr:
+        llvm::outs() << llvm::cast<NumberExpr>(node)->value << " ";
+        break;
+    case ASTNode::ND_VariableAssessExpr:
+        llvm::outs() << llvm::StringRef(node->token.ptr, node->token.length);
+        break;
+    default:
+        break;
     }
-    return nullptr;
 }
 
-llvm::Value *PrintVisitor::VisitBlockStmts(BlockStmts *blockStmts) {
-    llvm::outs() << "{\n";
-    for (auto node : blockStmts->nodeVec) {
+bool PrintVisitor::InVisit(ASTNode *node, unsigned childIdx) {
+    switch (node->nodeKind) {
+    case ASTNode::ND_DeclStmts:
+        if (childIdx > 0) {
+            llvm::outs() << "\n";
+        }
+        break;
+    case ASTNode::ND_BlockStmts:
+        if (childIdx > 0) {
+            llvm::outs() << "\n";
+        }
         llvm::outs() << "  ";
-        node->AcceptVisitor(this);
-        llvm::outs() << "\n";
-    }
-    llvm::outs() << "}\n";
-    return nullptr;
-}
-
-llvm::Value *PrintVisitor::VisitIfStmt(IfStmt *ifStmt) {
-    llvm::outs() << "if (";
-    ifStmt->condExpr->AcceptVisitor(this);
-    llvm::outs() << ")";
-    ifStmt->thenStmt->AcceptVisitor(this);
-    if (ifStmt->elseStmt) {
-        llvm::outs() << " \nelse ";
-        ifStmt->elseStmt->AcceptVisitor(this);
-        llvm::outs() << "\n";
-    }
-    return nullptr;
-}
-
-llvm::Value *PrintVisitor::VisitBinaryExpr(BinaryExpr *binaryExpr) {
-    binaryExpr->leftExpr->AcceptVisitor(this);
-
-    switch (binaryExpr->op) {
-    case OpCode::Add:
-        llvm::outs() << "+";
         break;
-    case OpCode::Sub:
-        llvm::outs() << "-";
+    case ASTNode::ND_IfStmt:
+        if (childIdx == 1) {
+            llvm::outs() << ")";
+        } else if (childIdx == 2) {
+            llvm::outs() << " \nelse ";
+        }
         break;
-    case OpCode::Mul:
-        llvm::outs() << "*";
+    case ASTNode::ND_BinaryExpr:
+        if (childIdx == 1) {
+            switch (llvm::cast<BinaryExpr>(node)->op) {
+            case OpCode::Add:
+                llvm::outs() << "+";
+                break;
+            case OpCode::Sub:
+                llvm::outs() << "-";
+                break;
+            case OpCode::Mul:
+                llvm::outs() << "*";
+                break;
+            case OpCode::Div:
+                llvm::outs() << "/";
+                break;
+            default:
+                break;
+            }
+            llvm::outs() << " ";
+        }
         break;
-    case OpCode::Div:
-        llvm::outs() << "/";
+    case ASTNode::ND_AssignExpr:
+        if (childIdx == 1) {
+            llvm::outs() << " = ";
+        }
         break;
     default:
         break;
     }
-    llvm::outs() << " ";
-
-    binaryExpr->rightExpr->AcceptVisitor(this);
-    return nullptr;
-}
-
-llvm::Value *PrintVisitor::VisitNumberExpr(NumberExpr *numberExpr) {
-    llvm::outs() << numberExpr->token.value << " ";
-    return nullptr;
+    return true;
 }
 
-llvm::Value *PrintVisitor::VisitVariableAssessExpr(VariableAssessExpr *variableAssessExpr) {
-    llvm::outs() << llvm::StringRef(variableAssessExpr->token.ptr,
-                                    variableAssessExpr->token.length);
-    return nullptr;
-}
-
-llvm::Value *PrintVisitor::VisitAssignExpr(AssignExpr *assignExpr) {
-    assignExpr->leftExpr->AcceptVisitor(this);
-    llvm::outs() << " = ";
-    assignExpr->rightExpr->AcceptVisitor(this);
-    return nullptr;
+void PrintVisitor::PostVisit(ASTNode *node) {
+    switch (node->nodeKind) {
+    case ASTNode::ND_DeclStmts:
+        if (!llvm::cast<DeclStmts>(node)->nodeVec.empty()) {
+            llvm::outs() << "\n";
+        }
+        break;
+    case ASTNode::ND_BlockStmts:
+        if (!llvm::cast<BlockStmts>(node)->nodeVec.empty()) {
+            llvm::outs() << "\n";
+        }
+        llvm::outs() << "}\n";
+        break;
+    case ASTNode::ND_IfStmt:
+        if (llvm::cast<IfStmt>(node)->elseStmt) {
+            llvm::outs() << "\n";
+        }
+        break;
+    default:
+        break;
+    }
 }
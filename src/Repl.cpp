@@ -0,0 +1,113 @@
+#include "include/Repl.h"
+#include "include/Lexer.h"
+#include "include/Parser.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/raw_ostream.h"
+#include <cstdio>
+
+std::unique_ptr<Repl> Repl::Create(unsigned optLevel, bool shareExprs, std::string &error) {
+    std::unique_ptr<JIT> jit = JIT::CreateForHost(optLevel, error);
+    if (!jit) {
+        return nullptr;
+    }
+    return std::unique_ptr<Repl>(new Repl(std::move(jit), shareExprs));
+}
+
+Repl::Repl(std::unique_ptr<JIT> jit, bool shareExprs)
+    : jit(std::move(jit)), codeGen(this->jit->GetContext()) {
+    diag.SetErrorsRecoverable(true);
+    sema.SetExprSharing(shareExprs);
+    codeGen.SetGlobalVariables(true);
+}
+
+int Repl::Run(std::istream &in) {
+    bool prompt = llvm::sys::Process::StandardInIsUserInput();
+    std::string input, line;
+    int depth   = 0; ///< Braces opened and not yet closed in `input`
+    bool failed = false;
+    while (true) {
+        if (prompt) {
+            llvm::outs() << (input.empty() ? "> " : "... ");
+            llvm::outs().flush();
+        }
+        if (!std::getline(in, line)) {
+            break;
+        }
+        for (char ch : line) {
+            depth += ch == '{' ? 1 : ch == '}' ? -1 : 0;
+        }
+        input += line;
+        input += '\n';
+
+        llvm::StringRef text = llvm::StringRef(input).rtrim();
+        if (text.empty()) {
+            input.clear();
+            continue;
+        }
+        if (depth > 0 || (text.back() != ';' && text.back() != '}')) {
+            continue;
+        }
+        failed = !RunInput(input) || failed;
+        input.clear();
+        depth = 0;
+    }
+    // Whatever is left is incomplete; parsing it reports what is missing.
+    if (!llvm::StringRef(input).trim().empty()) {
+        failed = !RunInput(input) || failed;
+    }
+    return failed ? -1 : 0;
+}
+
+bool Repl::RunInput(const std::string &input) {
+    unsigned bufferId = mgr.AddNewSourceBuffer(
+        llvm::MemoryBuffer::getMemBufferCopy(input, "<stdin>"), llvm::SMLoc());
+    Lexer lexer(mgr, diag, identifiers, bufferId);
+    Scope::Checkpoint checkpoint = sema.GetScopeCheckpoint();
+    bool ran                     = true;
+    try {
+        // The parser lexes its first token right away, so it can fail as well.
+        Parser parser(lexer, sema);
+        while (ran && !parser.IsAtEof()) {
+            checkpoint    = sema.GetScopeCheckpoint();
+            ASTNode *stmt = parser.ParserTopLevelStmt();
+            ran           = !stmt || RunStmt(stmt);
+            if (!ran) {
+                // Its module is gone, and with it the globals of the variables it declared.
+                sema.RollbackScope(checkpoint);
+            }
+            // Symbols and types live on; the AST of the statement is not needed anymore.
+            astContext.Reset();
+            sema.ForgetSharedExprs();
+            codeGen.ForgetSharedValues();
+        }
+    } catch (const Diagnostics::ReportedError &) {
+        // Already printed. The statement got no further than Sema, so only its scopes and symbols
+        // have to go; the statements before it have run and stay.
+        sema.RollbackScope(checkpoint);
+        astContext.Reset();
+        sema.ForgetSharedExprs();
+        codeGen.ForgetSharedValues();
+        ran = false;
+    }
+    return ran;
+}
+
+bool Repl::RunStmt(ASTNode *stmt) {
+    // The globals of variables are all named "<name>.<slot>", and no such name lacks a '.'.
+    std::string name = "__stmt" + std::to_string(++stmtCount);
+    codeGen.BeginMain(name);
+    codeGen.EmitStmt(stmt);
+    codeGen.FinishMain();
+
+    std::string error;
+    int result = 0;
+    if (!jit->AddModule(codeGen.TakeModule().second, error) || !jit->Call(name, result, error)) {
+        llvm::errs() << "can't run the statement: " << error << "\n";
+        jit->RemoveLastModule();
+        return false;
+    }
+    // The statement printed its value through C's stdout, which llvm::outs() does not flush.
+    fflush(stdout);
+    return true;
+}
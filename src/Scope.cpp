@@ -1,37 +1,47 @@
 #include "include/Scope.h"
-#include "llvm/Support/raw_ostream.h"
 
 Scope::Scope() {
-    envs.push_back(std::make_shared<Env>());
+    EnterScope();
 }
 
 void Scope::EnterScope() {
-    envs.push_back(std::make_shared<Env>());
+    scopeStarts.push_back(undoLog.size());
 }
 
 void Scope::ExitScope() {
-    envs.pop_back();
+    size_t start = scopeStarts.back();
+    scopeStarts.pop_back();
+    PopSymbols(start);
 }
 
-void Scope::AddSymbol(llvm::StringRef name, SymbolKind symbolKind, CType *cType) {
-    auto symbol = std::make_shared<Symbol>(name, symbolKind, cType);
-    envs.back()->variableSymbolTable.insert({name, symbol});
+void Scope::Rollback(Checkpoint checkpoint) {
+    assert(checkpoint.scopes <= scopeStarts.size() && "scope of the checkpoint already closed");
+    scopeStarts.resize(checkpoint.scopes);
+    PopSymbols(checkpoint.symbols);
 }
 
-std::shared_ptr<Symbol> Scope::FindVarSymbol(llvm::StringRef name) {
-    for (auto it = envs.rbegin(); it != envs.rend(); it++) {
-        llvm::StringMap<std::shared_ptr<Symbol>> &table = (*it)->variableSymbolTable;
-        if (table.count(name) > 0) {
-            return table[name];
-        }
+void Scope::PopSymbols(size_t size) {
+    while (undoLog.size() > size) {
+        Symbol *symbol            = undoLog.back();
+        bindings[symbol->GetId()] = symbol->shadowed;
+        undoLog.pop_back();
     }
-    return nullptr;
 }
 
-std::shared_ptr<Symbol> Scope::FindVarSymbolInCurrEnv(llvm::StringRef name) {
-    llvm::StringMap<std::shared_ptr<Symbol>> &table = envs.back()->variableSymbolTable;
-    if (table.count(name) >= 1) {
-        return table[name];
+Symbol *Scope::AddSymbol(IdentId id, llvm::StringRef name, SymbolKind symbolKind, CType *cType) {
+    if (id >= bindings.size()) {
+        bindings.resize(id + 1, nullptr);
     }
-    return nullptr;
-}
\ No newline at end of file
+    Symbol *symbol   = new (symbolPool.Allocate<Symbol>()) Symbol(id, name, symbolKind, cType);
+    symbol->slot     = symbolCount++;
+    symbol->depth    = scopeStarts.size();
+    symbol->shadowed = bindings[id];
+    bindings[id]     = symbol;
+    undoLog.push_back(symbol);
+    return symbol;
+}
+
+Symbol *Scope::FindVarSymbolInCurrEnv(IdentId id) const {
+    Symbol *symbol = FindVarSymbol(id);
+    return symbol && symbol->depth == scopeStarts.size() ? symbol : nullptr;
+}
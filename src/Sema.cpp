@@ -1,66 +1,206 @@
 #include "include/Sema.h"
+#include "llvm/Support/MathExtras.h"
+#include <climits>
 
-std::shared_ptr<ASTNode> Sema::SemaIfStmtNode(std::shared_ptr<ASTNode> condExpr,
-                                              std::shared_ptr<ASTNode> thenStmt,
-                                              std::shared_ptr<ASTNode> elseStmt) {
-    auto ifStmt      = std::make_shared<IfStmt>();
+ASTNode *Sema::SemaDeclStmtNode(llvm::ArrayRef<ASTNode *> nodeVec) {
+    return context.Create<DeclStmts>(context.CopyArray(nodeVec));
+}
+
+ASTNode *Sema::SemaBlockStmtNode(llvm::ArrayRef<ASTNode *> nodeVec) {
+    return context.Create<BlockStmts>(context.CopyArray(nodeVec));
+}
+
+ASTNode *Sema::SemaIfStmtNode(ASTNode *condExpr, ASTNode *thenStmt, ASTNode *elseStmt) {
+    if (auto cond = llvm::dyn_cast<NumberExpr>(condExpr)) {
+        // Only the branch that is taken is kept, as a block of its own, and an empty block stands
+        // for a branch that is missing.
+        ASTNode *taken = cond->value ? thenStmt : elseStmt;
+        if (!taken) {
+            return SemaBlockStmtNode({});
+        }
+        return llvm::isa<BlockStmts>(taken) ? taken : SemaBlockStmtNode(taken);
+    }
+
+    auto ifStmt      = context.Create<IfStmt>();
     ifStmt->condExpr = condExpr;
     ifStmt->thenStmt = thenStmt;
     ifStmt->elseStmt = elseStmt;
     return ifStmt;
 }
 
-std::shared_ptr<ASTNode> Sema::SemaVariableDeclNode(CType *cType, Token &tok) {
+ASTNode *Sema::SemaVariableDeclNode(CType *cType, Token &tok) {
     llvm::StringRef content = llvm::StringRef(tok.ptr, tok.length);
     // Check is redefined for symbol
-    std::shared_ptr<Symbol> symbol = scope.FindVarSymbolInCurrEnv(content);
+    Symbol *symbol = scope.FindVarSymbolInCurrEnv(tok.identId);
     if (symbol) {
         diager.Report(llvm::SMLoc::getFromPointer(tok.ptr), diag::error_redefined, content);
     }
-    scope.AddSymbol(content, SymbolKind::LocalVariable, cType);
+    symbol = scope.AddSymbol(tok.identId, content, SymbolKind::LocalVariable, cType);
+    RecordWrite(symbol);
 
-    auto variableDecl   = std::make_shared<VariableDecl>();
-    variableDecl->token = tok;
-    variableDecl->cType = cType;
+    auto variableDecl    = context.Create<VariableDecl>();
+    variableDecl->token  = tok;
+    variableDecl->cType  = cType;
+    variableDecl->symbol = symbol;
     return variableDecl;
 }
 
-std::shared_ptr<ASTNode>
-Sema::SemaAssignExprNode(std::shared_ptr<ASTNode> left, std::shared_ptr<ASTNode> right, Token tok) {
+ASTNode *Sema::SemaAssignExprNode(ASTNode *left, ASTNode *right, Token tok) {
     assert(left && right);
-    if (!llvm::isa<VariableAssessExpr>(left.get())) {
+    if (!llvm::isa<VariableAssessExpr>(left)) {
         diager.Report(llvm::SMLoc::getFromPointer(tok.ptr), diag::error_lvalue);
     }
-    auto expr   = std::make_shared<AssignExpr>(left, right);
-    expr->token = left->token;
+    auto expr    = context.Create<AssignExpr>(left, right);
+    expr->token  = left->token;
+    expr->cType  = left->cType;
+    expr->symbol = llvm::cast<VariableAssessExpr>(left)->symbol;
+    RecordWrite(expr->symbol);
     return expr;
 }
 
-std::shared_ptr<ASTNode> Sema::SemaVariableAccessExprNode(Token &tok) {
-    llvm::StringRef content        = llvm::StringRef(tok.ptr, tok.length);
-    std::shared_ptr<Symbol> symbol = scope.FindVarSymbol(content);
+ASTNode *Sema::SemaVariableAccessExprNode(Token &tok) {
+    Symbol *symbol = scope.FindVarSymbol(tok.identId);
     if (!symbol) {
-        diager.Report(llvm::SMLoc::getFromPointer(tok.ptr), diag::error_undefined, content);
+        diager.Report(llvm::SMLoc::getFromPointer(tok.ptr), diag::error_undefined, tok.GetText());
     }
 
-    auto expr   = std::make_shared<VariableAssessExpr>();
-    expr->token = tok;
-    expr->cType = symbol->cType;
+    SharedExprKey key(ASTNode::ND_VariableAssessExpr, symbol->version, symbol, nullptr);
+    if (ASTNode *shared = FindSharedExpr(key)) {
+        return shared;
+    }
+    auto expr    = context.Create<VariableAssessExpr>();
+    expr->token  = tok;
+    expr->cType  = symbol->cType;
+    expr->symbol = symbol;
+    if (shareExprs) {
+        sharedExprs[key] = expr;
+    }
     return expr;
 }
 
-std::shared_ptr<ASTNode>
-Sema::SemaBinaryExprNode(std::shared_ptr<ASTNode> left, OpCode op, std::shared_ptr<ASTNode> right) {
-    return std::make_shared<BinaryExpr>(left, op, right);
+ASTNode *Sema::SemaBinaryExprNode(ASTNode *left, OpCode op, ASTNode *right, Token tok) {
+    auto leftNumber  = llvm::dyn_cast<NumberExpr>(left);
+    auto rightNumber = llvm::dyn_cast<NumberExpr>(right);
+    // Only `int` is folded; the generated code converts wider literals to their common type.
+    CType *intTy = context.GetTypes().GetIntTy();
+    if (leftNumber && rightNumber && left->cType == intTy && right->cType == intTy) {
+        int value;
+        if (FoldBinaryExpr(static_cast<int>(leftNumber->value), op,
+                           static_cast<int>(rightNumber->value), tok, value)) {
+            return CreateNumberExpr(left->cType, value, tok);
+        }
+    }
+
+    SharedExprKey key(ASTNode::ND_BinaryExpr, static_cast<int64_t>(op), left, right);
+    if (ASTNode *shared = FindSharedExpr(key)) {
+        return shared;
+    }
+    auto expr   = context.Create<BinaryExpr>(left, op, right);
+    expr->cType = context.GetTypes().GetCommonType(left->cType, right->cType);
+    // An operand with a side effect is an AssignExpr, which is never shared, so its key can not
+    // come up again.
+    if (shareExprs) {
+        sharedExprs[key] = expr;
+    }
+    return expr;
 }
 
-std::shared_ptr<ASTNode> Sema::SemaNumberExprNode(CType *cType, Token &tok) {
-    auto expr   = std::make_shared<NumberExpr>();
+ASTNode *Sema::SemaNumberExprNode(Token &tok) {
+    llvm::StringRef suffix = tok.GetSuffix();
+    llvm::StringRef rest   = suffix;
+    bool isUnsigned        = rest.consume_front("u") || rest.consume_front("U");
+    unsigned longs         = rest.consume_front("ll") || rest.consume_front("LL") ? 2
+                             : rest.consume_front("l") || rest.consume_front("L") ? 1
+                                                                                  : 0;
+    if (!isUnsigned) {
+        isUnsigned = rest.consume_front("u") || rest.consume_front("U");
+    }
+    if (!rest.empty()) {
+        diager.Report(llvm::SMLoc::getFromPointer(tok.ptr), diag::error_literal_suffix, suffix);
+    }
+
+    TypeContext &types = context.GetTypes();
+    CType *cType       = nullptr;
+    uint64_t value     = 0;
+    bool fits          = tok.GetValue(value);
+    // The signed kinds are even and each unsigned one follows its signed one.
+    for (unsigned kind = static_cast<unsigned>(CTypeKind::Int) + 2 * longs;
+         kind <= static_cast<unsigned>(CTypeKind::ULongLong); kind += 2) {
+        cType         = types.GetIntegerType(static_cast<CTypeKind>(kind + isUnsigned));
+        unsigned bits = cType->GetSize() * 8 - cType->IsSigned();
+        if (fits && (bits == 64 || value >> bits == 0)) {
+            return CreateNumberExpr(cType, static_cast<int64_t>(value), tok);
+        }
+    }
+    diager.Report(llvm::SMLoc::getFromPointer(tok.ptr), diag::error_literal_too_large,
+                  cType->GetName());
+    return nullptr;
+}
+
+ASTNode *Sema::CreateNumberExpr(CType *cType, int64_t value, Token tok) {
+    SharedExprKey key(ASTNode::ND_NumberExpr, value, cType, nullptr);
+    if (ASTNode *shared = FindSharedExpr(key)) {
+        return shared;
+    }
+    auto expr   = context.Create<NumberExpr>();
     expr->token = tok;
     expr->cType = cType;
+    expr->value = value;
+    if (shareExprs) {
+        sharedExprs[key] = expr;
+    }
     return expr;
 }
 
+bool Sema::FoldBinaryExpr(int left, OpCode op, int right, Token tok, int &value) {
+    bool overflow = false;
+    switch (op) {
+    case OpCode::Add:
+        overflow = llvm::AddOverflow(left, right, value);
+        break;
+    case OpCode::Sub:
+        overflow = llvm::SubOverflow(left, right, value);
+        break;
+    case OpCode::Mul:
+        overflow = llvm::MulOverflow(left, right, value);
+        break;
+    case OpCode::Div:
+        // Both are undefined behavior; the division is left to run time, as a C compiler would.
+        if (right == 0) {
+            diager.Report(llvm::SMLoc::getFromPointer(tok.ptr), diag::warn_division_by_zero);
+            return false;
+        }
+        if (left == INT_MIN && right == -1) {
+            diager.Report(llvm::SMLoc::getFromPointer(tok.ptr), diag::warn_division_overflow);
+            return false;
+        }
+        value = left / right;
+        break;
+    }
+    if (overflow) {
+        diager.Report(llvm::SMLoc::getFromPointer(tok.ptr), diag::warn_integer_overflow, value);
+    }
+    return true;
+}
+
+ASTNode *Sema::FindSharedExpr(const SharedExprKey &key) {
+    if (!shareExprs) {
+        return nullptr;
+    }
+    auto it = sharedExprs.find(key);
+    if (it == sharedExprs.end()) {
+        return nullptr;
+    }
+    it->second->isShared = true;
+    return it->second;
+}
+
+void Sema::RecordWrite(Symbol *symbol) {
+    if (shareExprs) {
+        symbol->version = ++writeClock;
+    }
+}
+
 void Sema::EnterScope() {
     scope.EnterScope();
 }
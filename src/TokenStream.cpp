@@ -0,0 +1,39 @@
+#include "include/TokenStream.h"
+
+TokenStream::TokenStream(Lexer &lex) : lexer(lex), pos(0) {
+    if (lexer.ShouldLexInParallel()) {
+        lexer.LexAll(tokens);
+    }
+}
+
+const Token &TokenStream::Peek(unsigned k) {
+    if (pos + k >= tokens.size()) {
+        Fill(k + 1);
+    }
+    if (pos + k >= tokens.size()) {
+        return tokens.back(); // Eof
+    }
+    return tokens[pos + k];
+}
+
+Token TokenStream::Next() {
+    Token tok = Peek(0);
+    if (tok.tokenTy != TokenType::Eof) {
+        pos++;
+    }
+    return tok;
+}
+
+void TokenStream::Fill(size_t count) {
+    if (pos >= 64 && pos * 2 >= tokens.size()) {
+        tokens.erase(tokens.begin(), tokens.begin() + pos);
+        pos = 0;
+    }
+    while (tokens.size() - pos < count) {
+        if (!tokens.empty() && tokens.back().tokenTy == TokenType::Eof) {
+            return;
+        }
+        tokens.emplace_back();
+        lexer.NextToken(tokens.back());
+    }
+}
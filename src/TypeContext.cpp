@@ -0,0 +1,54 @@
+#include "include/TypeContext.h"
+
+namespace {
+/// Size in bytes of each integer type, by rank.
+constexpr unsigned INTEGER_SIZES[] = {1, 2, 4, 8, 8};
+constexpr unsigned POINTER_SIZE    = 8;
+} // namespace
+
+TypeContext::TypeContext() {
+    for (unsigned i = 0; i < INTEGER_TYPE_COUNT; i++) {
+        unsigned size   = INTEGER_SIZES[i / 2];
+        integerTypes[i] = Create(static_cast<CTypeKind>(i), size, size);
+    }
+}
+
+CType *TypeContext::GetPointerType(CType *pointee) {
+    CType *&pointer = pointerTypes[pointee];
+    if (!pointer) {
+        pointer = Create(CTypeKind::Pointer, POINTER_SIZE, POINTER_SIZE, pointee);
+    }
+    return pointer;
+}
+
+CType *TypeContext::GetArrayType(CType *element, uint64_t count) {
+    CType *&array = arrayTypes[{element, count}];
+    if (!array) {
+        array = Create(CTypeKind::Array, element->GetSize() * count, element->GetAlign(), element,
+                       count);
+    }
+    return array;
+}
+
+CType *TypeContext::GetCommonType(CType *lhs, CType *rhs) {
+    lhs = GetPromotedType(lhs);
+    rhs = GetPromotedType(rhs);
+    if (lhs == rhs) {
+        return lhs;
+    }
+    if (lhs->IsSigned() == rhs->IsSigned()) {
+        return lhs->GetRank() > rhs->GetRank() ? lhs : rhs;
+    }
+
+    CType *unsignedTy = lhs->IsSigned() ? rhs : lhs;
+    CType *signedTy   = lhs->IsSigned() ? lhs : rhs;
+    if (unsignedTy->GetRank() >= signedTy->GetRank()) {
+        return unsignedTy;
+    }
+    // The signed type has the higher rank: it wins if it can represent every value of the
+    // unsigned one, otherwise both become its unsigned counterpart.
+    if (signedTy->GetSize() > unsignedTy->GetSize()) {
+        return signedTy;
+    }
+    return GetUnsignedType(signedTy);
+}
@@ -0,0 +1,62 @@
+#pragma once
+#ifndef _ASTCONTEXT_H_
+#define _ASTCONTEXT_H_
+
+#include "TypeContext.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/Support/Allocator.h"
+#include <memory>
+#include <utility>
+
+/// @brief Owns the memory of every AST node built for one translation unit.
+/// @details Nodes and their child arrays are bump-allocated from a single arena and referenced
+/// through plain pointers, so building a node costs a pointer bump instead of a heap allocation
+/// plus a reference count, and the whole tree is released at once when the context is destroyed.
+/// Destructors of arena objects never run, so nodes must not own any other resources.
+///
+/// The context also owns the `TypeContext` the nodes' types come from.
+class ASTContext {
+  public:
+    ASTContext() = default;
+    ASTContext(const ASTContext &) = delete;
+    ASTContext &operator=(const ASTContext &) = delete;
+
+    /// @brief Constructs a `T` in the arena
+    template <typename T, typename... Args> T *Create(Args &&...args) {
+        void *mem = allocator.Allocate(sizeof(T), alignof(T));
+        return new (mem) T(std::forward<Args>(args)...);
+    }
+
+    /// @brief Copies `elems` into the arena, e.g. to freeze the children gathered by the parser
+    template <typename T> llvm::ArrayRef<T> CopyArray(llvm::ArrayRef<T> elems) {
+        if (elems.empty()) {
+            return {};
+        }
+        T *mem = allocator.Allocate<T>(elems.size());
+        std::uninitialized_copy(elems.begin(), elems.end(), mem);
+        return llvm::ArrayRef<T>(mem, elems.size());
+    }
+
+    /// @brief Releases every node created so far, keeping one slab around for reuse
+    /// @details Any pointer into the arena dangles afterwards. Types are not released, since
+    /// symbols outlive the statement that declared them. Used when compiling one top-level
+    /// statement at a time.
+    void Reset() {
+        allocator.Reset();
+    }
+
+    /// @brief Returns the number of bytes handed out so far
+    size_t GetBytesAllocated() const {
+        return allocator.getBytesAllocated();
+    }
+
+    TypeContext &GetTypes() {
+        return types;
+    }
+
+  private:
+    llvm::BumpPtrAllocator allocator;
+    TypeContext types;
+};
+
+#endif // _ASTCONTEXT_H_
@@ -0,0 +1,71 @@
+#pragma once
+#ifndef _ASTVISITOR_H_
+#define _ASTVISITOR_H_
+
+#include "Ast.h"
+
+/// @brief Statically dispatched visitor over AST nodes.
+/// @details `Visit` switches on `ASTNode::nodeKind` and calls the matching `Visit<Kind>` of
+/// `Derived` on the statically cast node, so handlers can be inlined and every pass chooses its own
+/// return type. A handler the derived class does not provide falls back to `VisitNode`, which
+/// returns a value-initialized `RetTy`.
+///
+/// `Visit` only dispatches on the node it is given; handlers visit children themselves, or the
+/// pass is combined with `ASTWalker` when the tree may be too deep to recurse over.
+template <typename Derived, typename RetTy = void> class ASTVisitor {
+  public:
+    RetTy Visit(ASTNode *node) {
+        Derived &derived = static_cast<Derived &>(*this);
+        switch (node->nodeKind) {
+        case ASTNode::ND_DeclStmts:
+            return derived.VisitDeclStmts(static_cast<DeclStmts *>(node));
+        case ASTNode::ND_BlockStmts:
+            return derived.VisitBlockStmts(static_cast<BlockStmts *>(node));
+        case ASTNode::ND_VariableDecl:
+            return derived.VisitVariableDecl(static_cast<VariableDecl *>(node));
+        case ASTNode::ND_IfStmt:
+            return derived.VisitIfStmt(static_cast<IfStmt *>(node));
+        case ASTNode::ND_BinaryExpr:
+            return derived.VisitBinaryExpr(static_cast<BinaryExpr *>(node));
+        case ASTNode::ND_NumberExpr:
+            return derived.VisitNumberExpr(static_cast<NumberExpr *>(node));
+        case ASTNode::ND_VariableAssessExpr:
+            return derived.VisitVariableAssessExpr(static_cast<VariableAssessExpr *>(node));
+        case ASTNode::ND_AssignExpr:
+            return derived.VisitAssignExpr(static_cast<AssignExpr *>(node));
+        }
+        return RetTy();
+    }
+
+  protected:
+    /// Default handlers; the derived class hides the ones it needs.
+    RetTy VisitNode(ASTNode *) {
+        return RetTy();
+    }
+    RetTy VisitDeclStmts(DeclStmts *node) {
+        return static_cast<Derived &>(*this).VisitNode(node);
+    }
+    RetTy VisitBlockStmts(BlockStmts *node) {
+        return static_cast<Derived &>(*this).VisitNode(node);
+    }
+    RetTy VisitVariableDecl(VariableDecl *node) {
+        return static_cast<Derived &>(*this).VisitNode(node);
+    }
+    RetTy VisitIfStmt(IfStmt *node) {
+        return static_cast<Derived &>(*this).VisitNode(node);
+    }
+    RetTy VisitBinaryExpr(BinaryExpr *node) {
+        return static_cast<Derived &>(*this).VisitNode(node);
+    }
+    RetTy VisitNumberExpr(NumberExpr *node) {
+        return static_cast<Derived &>(*this).VisitNode(node);
+    }
+    RetTy VisitVariableAssessExpr(VariableAssessExpr *node) {
+        return static_cast<Derived &>(*this).VisitNode(node);
+    }
+    RetTy VisitAssignExpr(AssignExpr *node) {
+        return static_cast<Derived &>(*this).VisitNode(node);
+    }
+};
+
+#endif // _ASTVISITOR_H_
@@ -0,0 +1,108 @@
+#pragma once
+#ifndef _ASTWALKER_H_
+#define _ASTWALKER_H_
+
+#include "Ast.h"
+#include "llvm/ADT/SmallVector.h"
+
+/// @brief Depth-first AST traversal that keeps its position on a heap-allocated worklist.
+/// @details `Walk` visits a subtree without recursing on the native stack, so the nesting depth it
+/// can handle is bounded by memory rather than by the thread's stack size. The derived class is
+/// notified through three hooks, all resolved statically (CRTP):
+///
+///   - `PreVisit(node)`              before any child of `node` is visited
+///   - `InVisit(node, childIdx)`     between children, right before child `childIdx`; returning
+///                                   false skips that child
+///   - `PostVisit(node)`             after the last child of `node` has been visited
+///
+/// Children are visited in source order: the statements of a `DeclStmts`/`BlockStmts`; the
+/// condition, then- and else-statement of an `IfStmt`; the left and right operand of a
+/// `BinaryExpr`/`AssignExpr`. An absent else-statement is not visited and gets no `InVisit`.
+template <typename Derived> class ASTWalker {
+  public:
+    /// @brief Visits `root` and every node below it
+    void Walk(ASTNode *root) {
+        Derived &derived = static_cast<Derived &>(*this);
+        derived.PreVisit(root);
+        worklist.push_back({root, 0});
+        while (!worklist.empty()) {
+            Frame &frame = worklist.back();
+            if (frame.nextChild == GetChildCount(frame.node)) {
+                ASTNode *node = frame.node;
+                worklist.pop_back();
+                derived.PostVisit(node);
+                continue;
+            }
+
+            ASTNode *parent = frame.node;
+            unsigned idx    = frame.nextChild++;
+            ASTNode *child  = GetChild(parent, idx);
+            if (!child || !derived.InVisit(parent, idx)) {
+                continue;
+            }
+            derived.PreVisit(child);
+            // `frame` may dangle from here on.
+            worklist.push_back({child, 0});
+        }
+    }
+
+    /// @brief Returns how many child slots `node` has, including an absent else-statement
+    static unsigned GetChildCount(ASTNode *node) {
+        switch (node->nodeKind) {
+        case ASTNode::ND_DeclStmts:
+            return static_cast<DeclStmts *>(node)->nodeVec.size();
+        case ASTNode::ND_BlockStmts:
+            return static_cast<BlockStmts *>(node)->nodeVec.size();
+        case ASTNode::ND_IfStmt:
+            return 3;
+        case ASTNode::ND_BinaryExpr:
+        case ASTNode::ND_AssignExpr:
+            return 2;
+        default:
+            return 0;
+        }
+    }
+
+    /// @brief Returns child `idx` of `node`, or nullptr for an absent else-statement
+    static ASTNode *GetChild(ASTNode *node, unsigned idx) {
+        switch (node->nodeKind) {
+        case ASTNode::ND_DeclStmts:
+            return static_cast<DeclStmts *>(node)->nodeVec[idx];
+        case ASTNode::ND_BlockStmts:
+            return static_cast<BlockStmts *>(node)->nodeVec[idx];
+        case ASTNode::ND_IfStmt: {
+            auto ifStmt = static_cast<IfStmt *>(node);
+            return idx == 0 ? ifStmt->condExpr : idx == 1 ? ifStmt->thenStmt : ifStmt->elseStmt;
+        }
+        case ASTNode::ND_BinaryExpr: {
+            auto binaryExpr = static_cast<BinaryExpr *>(node);
+            return idx == 0 ? binaryExpr->leftExpr : binaryExpr->rightExpr;
+        }
+        case ASTNode::ND_AssignExpr: {
+            auto assignExpr = static_cast<AssignExpr *>(node);
+            return idx == 0 ? assignExpr->leftExpr : assignExpr->rightExpr;
+        }
+        default:
+            return nullptr;
+        }
+    }
+
+  protected:
+    /// Default hooks; the derived class hides the ones it needs.
+    void PreVisit(ASTNode *) {
+    }
+    bool InVisit(ASTNode *, unsigned) {
+        return true;
+    }
+    void PostVisit(ASTNode *) {
+    }
+
+  private:
+    struct Frame {
+        ASTNode *node;
+        unsigned nextChild;
+    };
+    llvm::SmallVector<Frame, 32> worklist;
+};
+
+#endif // _ASTWALKER_H_
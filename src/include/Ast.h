@@ -5,10 +5,9 @@
 #include "CType.h"
 #include "Lexer.h"
 
-#include "llvm/IR/Value.h"
-#include <memory>
-#include <vector>
+#include "llvm/ADT/ArrayRef.h"
 
+class Symbol;
 class Program;
 class ASTNode;
 class VariableDecl;
@@ -20,38 +19,18 @@ class DeclStmts;
 class BlockStmts;
 class IfStmt;
 
-/// @brief Base class for the visitor in the Visitor design pattern.
-/// @details This class defines a set of pure virtual functions to visit different nodes of an
-/// Abstract Syntax Tree (AST). By inheriting from this class and implementing its virtual
-/// functions, specific visitors can be created, such as `PrintVisitor` for printing AST node
-/// information or `CodeGen` for generating LLVM IR code. This class enables functionality to be
-/// extended without modifying the AST node classes.
-class Visitor {
-  public:
-    virtual ~Visitor() {
-    }
-    virtual llvm::Value *VisitProgram(Program *program)                                  = 0;
-    virtual llvm::Value *VisitDeclStmts(DeclStmts *declStmts)                            = 0;
-    virtual llvm::Value *VisitVariableDecl(VariableDecl *variableDecl)                   = 0;
-    virtual llvm::Value *VisitBlockStmts(BlockStmts *blockStmts)                         = 0;
-    virtual llvm::Value *VisitIfStmt(IfStmt *ifStmt)                                     = 0;
-    virtual llvm::Value *VisitBinaryExpr(BinaryExpr *binaryExpr)                         = 0;
-    virtual llvm::Value *VisitNumberExpr(NumberExpr *numberExpr)                         = 0;
-    virtual llvm::Value *VisitVariableAssessExpr(VariableAssessExpr *variableAssessExpr) = 0;
-    virtual llvm::Value *VisitAssignExpr(AssignExpr *assignExpr)                         = 0;
-};
-
+/// @brief Root of the AST; it and every node below it live in an `ASTContext`.
 class Program {
   public:
-    std::vector<std::shared_ptr<ASTNode>> stmts;
+    llvm::ArrayRef<ASTNode *> stmts;
 
   public:
-    Program(std::vector<std::shared_ptr<ASTNode>> stmts);
-    llvm::Value *AcceptVisitor(Visitor *v) {
-        return v->VisitProgram(this);
-    }
+    Program(llvm::ArrayRef<ASTNode *> stmts);
 };
 
+/// @brief Base of every AST node.
+/// @details Nodes carry no vtable; passes dispatch on `nodeKind`, either through `ASTVisitor` or
+/// through the hooks of `ASTWalker`.
 class ASTNode {
   public:
     enum Nodekind {
@@ -68,28 +47,21 @@ class ASTNode {
   public:
     CType *cType;
     Nodekind nodeKind;
+    bool isShared; ///< Handed out more than once by Sema's expression sharing; see `Sema`
     Token token;
 
   public:
-    ASTNode(Nodekind kind) : nodeKind(kind) {
-    }
-    virtual ~ASTNode() {
-    }
-    virtual llvm::Value *AcceptVisitor(Visitor *v) {
-        return nullptr;
+    ASTNode(Nodekind kind) : cType(nullptr), nodeKind(kind), isShared(false) {
     }
 };
 
 class DeclStmts : public ASTNode {
   public:
-    std::vector<std::shared_ptr<ASTNode>> nodeVec;
+    llvm::ArrayRef<ASTNode *> nodeVec;
 
   public:
-    DeclStmts() : ASTNode(Nodekind::ND_DeclStmts) {
-    }
-
-    llvm::Value *AcceptVisitor(Visitor *v) override {
-        return v->VisitDeclStmts(this);
+    DeclStmts(llvm::ArrayRef<ASTNode *> nodeVec)
+        : ASTNode(Nodekind::ND_DeclStmts), nodeVec(nodeVec) {
     }
 
     static bool classof(const ASTNode *node) {
@@ -99,11 +71,10 @@ class DeclStmts : public ASTNode {
 
 class VariableDecl : public ASTNode {
   public:
-    VariableDecl() : ASTNode(Nodekind::ND_VariableDecl) {
-    }
+    Symbol *symbol = nullptr; ///< The declared variable
 
-    llvm::Value *AcceptVisitor(Visitor *v) override {
-        return v->VisitVariableDecl(this);
+  public:
+    VariableDecl() : ASTNode(Nodekind::ND_VariableDecl) {
     }
 
     static bool classof(const ASTNode *node) {
@@ -113,14 +84,11 @@ class VariableDecl : public ASTNode {
 
 class BlockStmts : public ASTNode {
   public:
-    std::vector<std::shared_ptr<ASTNode>> nodeVec;
+    llvm::ArrayRef<ASTNode *> nodeVec;
 
   public:
-    BlockStmts() : ASTNode(Nodekind::ND_BlockStmts) {
-    }
-
-    llvm::Value *AcceptVisitor(Visitor *v) override {
-        return v->VisitBlockStmts(this);
+    BlockStmts(llvm::ArrayRef<ASTNode *> nodeVec)
+        : ASTNode(Nodekind::ND_BlockStmts), nodeVec(nodeVec) {
     }
 
     static bool classof(const ASTNode *node) {
@@ -130,18 +98,14 @@ class BlockStmts : public ASTNode {
 
 class IfStmt : public ASTNode {
   public:
-    std::shared_ptr<ASTNode> condExpr;
-    std::shared_ptr<ASTNode> thenStmt;
-    std::shared_ptr<ASTNode> elseStmt;
+    ASTNode *condExpr = nullptr;
+    ASTNode *thenStmt = nullptr;
+    ASTNode *elseStmt = nullptr;
 
   public:
     IfStmt() : ASTNode(Nodekind::ND_IfStmt) {
     }
 
-    llvm::Value *AcceptVisitor(Visitor *v) override {
-        return v->VisitIfStmt(this);
-    }
-
     static bool classof(const ASTNode *node) {
         return node->nodeKind == Nodekind::ND_IfStmt;
     }
@@ -157,18 +121,14 @@ enum class OpCode {
 class BinaryExpr : public ASTNode {
   public:
     OpCode op;
-    std::shared_ptr<ASTNode> leftExpr;
-    std::shared_ptr<ASTNode> rightExpr;
+    ASTNode *leftExpr;
+    ASTNode *rightExpr;
 
   public:
-    BinaryExpr(std::shared_ptr<ASTNode> left, OpCode op, std::shared_ptr<ASTNode> right)
+    BinaryExpr(ASTNode *left, OpCode op, ASTNode *right)
         : leftExpr(left), op(op), rightExpr(right), ASTNode(Nodekind::ND_BinaryExpr) {
     }
 
-    llvm::Value *AcceptVisitor(Visitor *v) override {
-        return v->VisitBinaryExpr(this);
-    }
-
     static bool classof(const ASTNode *node) {
         return node->nodeKind == Nodekind::ND_BinaryExpr;
     }
@@ -176,11 +136,10 @@ class BinaryExpr : public ASTNode {
 
 class NumberExpr : public ASTNode {
   public:
-    NumberExpr() : ASTNode(Nodekind::ND_NumberExpr) {
-    }
+    int64_t value; ///< An `unsigned long long` above `INT64_MAX` keeps its bits
 
-    llvm::Value *AcceptVisitor(Visitor *v) override {
-        return v->VisitNumberExpr(this);
+  public:
+    NumberExpr() : ASTNode(Nodekind::ND_NumberExpr) {
     }
 
     static bool classof(const ASTNode *node) {
@@ -190,11 +149,10 @@ class NumberExpr : public ASTNode {
 
 class VariableAssessExpr : public ASTNode {
   public:
-    VariableAssessExpr() : ASTNode(Nodekind::ND_VariableAssessExpr) {
-    }
+    Symbol *symbol = nullptr; ///< The variable the name resolved to
 
-    llvm::Value *AcceptVisitor(Visitor *v) override {
-        return v->VisitVariableAssessExpr(this);
+  public:
+    VariableAssessExpr() : ASTNode(Nodekind::ND_VariableAssessExpr) {
     }
 
     static bool classof(const ASTNode *node) {
@@ -204,18 +162,15 @@ class VariableAssessExpr : public ASTNode {
 
 class AssignExpr : public ASTNode {
   public:
-    std::shared_ptr<ASTNode> leftExpr;
-    std::shared_ptr<ASTNode> rightExpr;
+    ASTNode *leftExpr;
+    ASTNode *rightExpr;
+    Symbol *symbol = nullptr; ///< The variable assigned to, as resolved for `leftExpr`
 
   public:
-    AssignExpr(std::shared_ptr<ASTNode> left, std::shared_ptr<ASTNode> right)
+    AssignExpr(ASTNode *left, ASTNode *right)
         : leftExpr(left), rightExpr(right), ASTNode(Nodekind::ND_AssignExpr) {
     }
 
-    llvm::Value *AcceptVisitor(Visitor *v) override {
-        return v->VisitAssignExpr(this);
-    }
-
     static bool classof(const ASTNode *node) {
         return node->nodeKind == Nodekind::ND_AssignExpr;
     }
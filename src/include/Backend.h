@@ -0,0 +1,55 @@
+#pragma once
+#ifndef _BACKEND_H_
+#define _BACKEND_H_
+
+#include "llvm/Config/llvm-config.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetMachine.h"
+#include <memory>
+#include <string>
+
+/// @brief Generates native code for the host through an `llvm::TargetMachine`.
+/// @details The module must be configured for the target with `ConfigureModule` before it is
+/// optimized, so the optimizer sees the target's data layout.
+class Backend {
+  public:
+#if LLVM_VERSION_MAJOR >= 18
+    using CodeGenLevel = llvm::CodeGenOptLevel;
+#else
+    using CodeGenLevel = llvm::CodeGenOpt::Level;
+#endif
+
+    enum class FileKind {
+        Assembly, ///< Textual assembly, as for -S
+        Object,   ///< Relocatable object file, as for -c
+    };
+
+    /// @brief Creates the target machine of the host
+    /// @param optLevel 0 to 3, the code generator's optimization level
+    /// @details Returns nullptr and sets `error` when the host target is not linked in.
+    static std::unique_ptr<Backend> CreateForHost(unsigned optLevel, std::string &error);
+
+    /// @brief Maps an -O level, 0 to 3, to the code generator's optimization level
+    static CodeGenLevel GetCodeGenLevel(unsigned optLevel);
+
+    llvm::TargetMachine *GetTargetMachine() {
+        return targetMachine.get();
+    }
+
+    /// @brief Sets the target triple and data layout of `module`
+    void ConfigureModule(llvm::Module &module);
+
+    /// @brief Writes `module` to `os` as `kind`; returns false if the target can not emit it
+    bool Emit(llvm::Module &module, FileKind kind, llvm::raw_pwrite_stream &os);
+
+  private:
+    Backend(std::unique_ptr<llvm::TargetMachine> targetMachine)
+        : targetMachine(std::move(targetMachine)) {
+    }
+
+  private:
+    std::unique_ptr<llvm::TargetMachine> targetMachine;
+};
+
+#endif // _BACKEND_H_
@@ -2,23 +2,82 @@
 #ifndef _CTYPE_H_
 #define _CTYPE_H_
 
-enum class CTypeKind {
-    Int = 0,
+#include <cstdint>
+#include <string>
+
+enum class CTypeKind : uint8_t {
+    Char = 0, ///< Plain `char` is signed, as on x86-64
+    UChar,
+    Short,
+    UShort,
+    Int,
+    UInt,
+    Long,
+    ULong,
+    LongLong,
+    ULongLong,
+    Pointer,
+    Array,
 };
 
 /// @brief Represents a data type in the C language.
 /// @details This class is used to describe C language data types, including their size,
-/// alignment requirements, and kind (e.g., integer types). It provides utilities for defining
-/// specific types such as `int`.
+/// alignment requirements, and kind (e.g., integer types). Types are created and uniqued by a
+/// `TypeContext`, so two types are the same exactly when their pointers are equal.
 class CType {
   public:
-    CType(int size, int align, CTypeKind kind);
-    static CType *getIntTy();
+    CTypeKind GetKind() const {
+        return kind;
+    }
+
+    /// @brief Returns the size in bytes
+    uint64_t GetSize() const {
+        return size;
+    }
+
+    /// @brief Returns the alignment in bytes
+    unsigned GetAlign() const {
+        return align;
+    }
+
+    bool IsInteger() const {
+        return kind <= CTypeKind::ULongLong;
+    }
+
+    bool IsSigned() const {
+        return IsInteger() && static_cast<unsigned>(kind) % 2 == 0;
+    }
+
+    /// @brief Returns the integer conversion rank: `char` < `short` < `int` < `long` < `long long`
+    unsigned GetRank() const {
+        return static_cast<unsigned>(kind) / 2;
+    }
+
+    /// @brief Returns the pointee of a pointer or the element type of an array, nullptr otherwise
+    CType *GetElementType() const {
+        return elementTy;
+    }
+
+    /// @brief Returns the number of elements of an array, 0 otherwise
+    uint64_t GetArraySize() const {
+        return arraySize;
+    }
+
+    /// @brief Returns the type as it is spelled in C, e.g. "unsigned short" or "int *"
+    std::string GetName() const;
 
   private:
-    int size;
-    int align;
+    CType(CTypeKind kind, uint64_t size, unsigned align, CType *elementTy = nullptr,
+          uint64_t arraySize = 0);
+
+  private:
+    uint64_t size;
+    uint64_t arraySize;
+    CType *elementTy;
+    unsigned align;
     CTypeKind kind;
+
+    friend class TypeContext;
 };
 
-#endif //_CTYPE_H_
\ No newline at end of file
+#endif //_CTYPE_H_
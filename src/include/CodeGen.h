@@ -1,38 +1,195 @@
 #pragma once
 #ifndef _CODEGEN_H_
 #define _CODEGEN_H_
+#include "ASTVisitor.h"
+#include "ASTWalker.h"
 #include "Ast.h"
+#include "FlatAST.h"
+#include "Scope.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 
 /// @brief Code generation class for generating LLVM IR.
-/// @details This class implements the `Visitor` interface to traverse the Abstract Syntax Tree
-/// (AST) and generate corresponding LLVM IR code. It manages an LLVM context, IR builder, and
-/// module, which are used to create IR instructions and define program structure.
+/// @details This class walks the Abstract Syntax Tree (AST) with `ASTWalker` and generates the
+/// corresponding LLVM IR code. It manages an LLVM context, IR builder, and module, which are used
+/// to create IR instructions and define program structure.
 ///
-/// The class also maintains a mapping between variable names and their
-/// corresponding LLVM IR values and types, enabling efficient code generation
-/// for variable declarations, assignments, and accesses.
-class CodeGen : public Visitor {
+/// Every node leaves exactly one `llvm::Value *` on `valueStack` once it has been visited (nullptr
+/// for nodes that produce no value), which is how operands reach the node that consumes them.
+///
+/// Variables are found through the `Symbol` Sema resolved them to: the address and type of each
+/// variable live in a table indexed by the symbol's slot, so a shadowed name gets storage of its
+/// own and no access hashes a name.
+///
+/// Allocas are all placed at the start of the entry block, through a builder of their own, however
+/// deep in the control flow the declaration is. That keeps the stack frame static and lets
+/// mem2reg/SROA promote every variable.
+///
+/// With direct SSA construction enabled, variables get no storage at all. CodeGen tracks the
+/// current value of each variable per basic block, in the manner of Braun et al.'s on-the-fly SSA
+/// construction, and a read that reaches a merge block whose predecessors disagree creates a phi
+/// there. The emitted IR is then in SSA form without running mem2reg.
+///
+/// With global variables enabled, as for the REPL, every variable is a global named after its
+/// symbol instead, so its value outlives the function that declared it. Each statement can then be
+/// emitted into a module of its own: a later module declares the globals it uses on first access.
+///
+/// A value is held in the LLVM integer type as wide as its `CType`. Operands are converted to the
+/// type Sema gave the expression, sign- or zero-extended by the signedness of their own type.
+class CodeGen : public ASTWalker<CodeGen>, public ASTVisitor<CodeGen> {
   public:
-    CodeGen(std::shared_ptr<Program> program);
-    llvm::Value *VisitProgram(Program *program) override;
-    llvm::Value *VisitDeclStmts(DeclStmts *declStmts) override;
-    llvm::Value *VisitBlockStmts(BlockStmts *blockStmts) override;
-    llvm::Value *VisitVariableDecl(VariableDecl *VariableDecl) override;
-    llvm::Value *VisitIfStmt(IfStmt *ifStmt) override;
-    llvm::Value *VisitBinaryExpr(BinaryExpr *binaryExpr) override;
-    llvm::Value *VisitNumberExpr(NumberExpr *numberExpr) override;
-    llvm::Value *VisitVariableAssessExpr(VariableAssessExpr *variableAssessExpr) override;
-    llvm::Value *VisitAssignExpr(AssignExpr *assignExpr) override;
+    /// @brief Creates an empty module; `main` is built with `BeginMain`/`EmitStmt`/`FinishMain`
+    CodeGen();
+
+    /// @brief Same as above, creating the modules in `context`, which must outlive them
+    CodeGen(llvm::LLVMContext &context);
+
+    /// @brief Generates the whole of `program` into `main`
+    CodeGen(Program *program);
+    llvm::Value *VisitProgram(Program *program);
+
+    /// @brief Declares `printf`, creates `main` and points the builder at its entry block
+    /// @details `name` replaces "main" as the function's name. A new module is created first if
+    /// the last one was taken with `TakeModule`.
+    void BeginMain(llvm::StringRef name = "main");
+
+    /// @brief Appends one top-level statement to `main`
+    /// @details Nothing refers to `stmt` once this returns, so its AST can be freed right away.
+    /// The value of the last statement is printed by `FinishMain`; a block or an if-statement
+    /// has none.
+    void EmitStmt(ASTNode *stmt);
+
+    /// @brief Enables or disables building SSA form directly, instead of an alloca per variable
+    /// @details Must be set before `BeginMain`.
+    void SetDirectSSA(bool enable) {
+        directSSA = enable;
+    }
+
+    /// @brief Enables or disables giving every variable a global instead of an alloca
+    /// @details Must be set before `BeginMain`, and excludes direct SSA construction. A declaration
+    /// then produces no value, and `FinishMain` prints nothing for a statement without one.
+    void SetGlobalVariables(bool enable) {
+        globalVars = enable;
+    }
+
+    /// @brief Forgets the values of shared expressions; required whenever the `ASTContext` is reset
+    void ForgetSharedValues() {
+        sharedValues.clear();
+    }
+
+    /// @brief Appends top-level statement `stmt` of a flattened AST to `main`
+    void EmitStmt(const FlatAST &ast, FlatAST::NodeId stmt);
+
+    /// @brief Prints the value of the last statement and returns from `main`
+    void FinishMain();
+
+    /// @brief Returns the module holding the generated `main`
+    llvm::Module *GetModule() {
+        return llvmModule.get();
+    }
+
+    /// @brief Hands the module over to the caller, e.g. a JIT, along with the context owning it
+    /// @details Nothing can be emitted afterwards.
+    std::pair<std::unique_ptr<llvm::LLVMContext>, std::unique_ptr<llvm::Module>> TakeModule() {
+        return {std::move(ownedContext), std::move(llvmModule)};
+    }
 
   private:
-    llvm::LLVMContext llvmContext;
+    friend class ASTWalker<CodeGen>;
+    void PreVisit(ASTNode *node);
+    bool InVisit(ASTNode *node, unsigned childIdx);
+    void PostVisit(ASTNode *node);
+
+    /// @brief Post-order handlers, dispatched from `PostVisit`
+    friend class ASTVisitor<CodeGen>;
+    void VisitDeclStmts(DeclStmts *declStmts);
+    void VisitBlockStmts(BlockStmts *blockStmts);
+    void VisitVariableDecl(VariableDecl *variableDecl);
+    void VisitIfStmt(IfStmt *ifStmt);
+    void VisitBinaryExpr(BinaryExpr *binaryExpr);
+    void VisitNumberExpr(NumberExpr *numberExpr);
+    void VisitVariableAssessExpr(VariableAssessExpr *variableAssessExpr);
+    void VisitAssignExpr(AssignExpr *assignExpr);
+
+    /// @brief Node emitters shared by the pointer and the flat traversal
+    /// @details Operands are popped from `valueStack` and the result pushed back onto it.
+    void EmitIfBegin(bool hasElse);
+    void EmitIfBranch(unsigned childIdx);
+    void EmitIfEnd();
+    void EmitBinaryExpr(OpCode op, CType *leftTy, CType *rightTy, CType *resultTy);
+    void EmitNumberExpr(int64_t value, CType *cType);
+    void EmitVariableDecl(CType *cType, unsigned slot, llvm::StringRef name);
+    void EmitVariableAccess(unsigned slot, llvm::StringRef name);
+    void EmitAssign(unsigned slot, llvm::StringRef name, CType *valueTy);
+
+    /// @brief Returns the storage of variable `slot`, declaring its global in this module if needed
+    llvm::Value *GetVariableAddress(unsigned slot, llvm::StringRef name);
+
+    /// @brief Returns the name of the global of variable `slot`, unique across modules
+    static std::string GetGlobalName(unsigned slot, llvm::StringRef name);
+
+    /// @brief Returns the LLVM type of `cType`, lowering it on first use
+    llvm::Type *ConvertType(CType *cType);
+
+    /// @brief Converts `value` of type `from` to type `to`
+    llvm::Value *EmitConversion(llvm::Value *value, CType *from, CType *to);
+
+    /// @brief Records `value` as the current value of variable `slot` in `block`
+    void WriteVariable(unsigned slot, llvm::BasicBlock *block, llvm::Value *value) {
+        currentDefs[{slot, block}] = value;
+    }
+
+    /// @brief Returns the value of variable `slot` on entry to the end of `block`, creating phis in
+    /// the merge blocks on the way where the predecessors disagree
+    llvm::Value *ReadVariable(unsigned slot, llvm::StringRef name, llvm::BasicBlock *block);
+
+    /// @brief Pushes the value already emitted for `node` in the current basic block, if any
+    /// @details Only nodes Sema handed out more than once (`isShared`) are remembered. A value is
+    /// reused only within the block it was emitted in, which trivially dominates the reuse.
+    bool ReuseSharedValue(ASTNode *node);
+
+    /// @brief Pops the values of the last `count` visited nodes, keeping the last one
+    void CollapseValues(size_t count);
+
+  private:
+    /// @brief Blocks of an if-statement whose children are still being visited
+    struct IfBlocks {
+        llvm::BasicBlock *thenBB;
+        llvm::BasicBlock *elseBB;
+        llvm::BasicBlock *lastBB;
+    };
+
+    /// @brief Storage of a variable
+    struct VarSlot {
+        llvm::Value *addr; ///< nullptr with direct SSA construction or global variables
+        llvm::Type *ty;
+        CType *cType;
+    };
+
+    std::unique_ptr<llvm::LLVMContext> ownedContext{std::make_unique<llvm::LLVMContext>()};
+    llvm::LLVMContext &llvmContext{*ownedContext};
     llvm::IRBuilder<> irBuilder{llvmContext};
-    std::shared_ptr<llvm::Module> llvmModule;
+    llvm::IRBuilder<> allocaBuilder{llvmContext}; ///< Inserts before `allocaInsertPt`
+    /// Placeholder that ends the alloca prefix of the entry block; erased by `FinishMain`
+    llvm::Instruction *allocaInsertPt{nullptr};
+    std::unique_ptr<llvm::Module> llvmModule;
     llvm::Function *currFunc{nullptr};
-    llvm::StringMap<std::pair<llvm::Value *, llvm::Type *>> varAddrTypeMap;
+    llvm::Function *printfFunc{nullptr};
+    llvm::Value *lastVal{nullptr}; ///< Value of the last top-level statement emitted
+    CType *lastType{nullptr};      ///< Its type, or nullptr when the statement has no value
+    std::vector<VarSlot> varAddrs; ///< Indexed by `Symbol` slot
+    llvm::DenseMap<CType *, llvm::Type *> llvmTypes; ///< Cache of `ConvertType`
+    llvm::SmallVector<llvm::Value *, 32> valueStack;
+    llvm::SmallVector<IfBlocks, 8> ifStack;
+    llvm::DenseMap<ASTNode *, std::pair<llvm::BasicBlock *, llvm::Value *>> sharedValues;
+    bool directSSA{false};
+    bool globalVars{false};
+    /// Globals of variables defined or declared in the current module, keyed by `Symbol` slot
+    llvm::DenseMap<unsigned, llvm::GlobalVariable *> moduleGlobals;
+    /// Value of each variable at the end of each block it was written or looked up in, keyed by
+    /// `Symbol` slot and block. Only used with direct SSA construction.
+    llvm::DenseMap<std::pair<unsigned, llvm::BasicBlock *>, llvm::Value *> currentDefs;
 };
 
 #endif // _CODEGEN_H_
\ No newline at end of file
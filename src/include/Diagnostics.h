@@ -5,6 +5,7 @@
 
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/SourceMgr.h"
+#include <vector>
 
 namespace diag {
 enum {
@@ -17,25 +18,59 @@ enum {
 /// @details This class is used for reporting diagnostics such as errors, warnings, and notes during
 /// compilation or interpretation. It integrates with LLVM's `SourceMgr` to associate messages with
 /// source code locations and manage diagnostic types and messages defined in `Diagnostics.inc`.
+///
+/// An error ends the process once it is reported, unless errors were made recoverable: it is then
+/// thrown as a `ReportedError` for the caller to discard whatever it was working on, as the REPL
+/// does with the statement being parsed.
+///
+/// It also owns the line-start index used to turn a location into a row and column. The index of
+/// a buffer is built the first time a location in it is queried, so the lexer never tracks rows.
 class Diagnostics {
   public:
+    /// @brief Thrown by `Report` after an error was printed, when errors are recoverable
+    struct ReportedError {};
+
     Diagnostics(llvm::SourceMgr &mgr) : mgr(mgr) {
     }
 
+    /// @brief Makes `Report` throw `ReportedError` for an error instead of exiting
+    void SetErrorsRecoverable(bool enable) {
+        recoverable = enable;
+    }
+
     template <typename... Args> void Report(llvm::SMLoc loc, unsigned int diagId, Args... args) {
         auto kind = GetDiagKind(diagId);
         auto msg  = GetDiagMsg(diagId);
         auto m    = llvm::formatv(msg, std::forward<Args>(args)...).str();
         mgr.PrintMessage(loc, kind, m);
         if (kind == llvm::SourceMgr::DK_Error) {
+            if (recoverable) {
+                throw ReportedError();
+            }
             exit(-1);
         }
     }
 
+    /// @brief Returns the 1-based (row, column) of `loc`
+    /// @details The row is found by binary search over the line starts of the buffer holding `loc`
+    /// and the column is the distance to that line start, so the cost does not depend on line
+    /// length.
+    std::pair<unsigned, unsigned> GetRowCol(llvm::SMLoc loc);
+
   private:
     llvm::SourceMgr &mgr;
+    bool recoverable = false;
+
+    /// Offsets of the first character of every line in one buffer.
+    struct LineIndex {
+        const char *bufStart = nullptr;
+        std::vector<size_t> lineStarts;
+    };
+    std::vector<LineIndex> lineIndexes; ///< Indexed by buffer id - 1, built on demand
+    unsigned lastBufferId = 0;          ///< Buffer of the previous query
 
   private:
+    const LineIndex &GetLineIndex(llvm::SMLoc loc);
     llvm::SourceMgr::DiagKind GetDiagKind(unsigned int id);
     const char *GetDiagMsg(unsigned int id);
 };
@@ -0,0 +1,143 @@
+#pragma once
+#ifndef _FLATAST_H_
+#define _FLATAST_H_
+
+#include "Ast.h"
+#include "TypeContext.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/FileSystem.h"
+#include <cstdint>
+#include <memory>
+#include <system_error>
+#include <vector>
+
+/// @brief Structure-of-arrays copy of a `Program`.
+/// @details Nodes are numbered in post-order (children before their parent) and every attribute
+/// lives in its own contiguous column indexed by that number:
+///
+///   kinds       `ASTNode::Nodekind` of each node
+///   types       `CTypeKind` of the node's `cType`, or `NO_TYPE`; only integer types are stored
+///   data        `NumberExpr` value, `BinaryExpr` opcode, or the `Symbol` slot of a variable
+///               declaration, access or assignment; 0 otherwise
+///   tokOffsets  offset of the node's token from the start of the source buffer
+///   tokLengths  length of that token
+///   childBegin  children of node `i` are `children[childBegin[i], childBegin[i + 1])`
+///
+/// An `IfStmt` always has three children, the else-statement being `NO_NODE` when absent. Every
+/// column is trivially copyable, so a tree can be copied or written out with a memcpy per column.
+///
+/// `Save` writes the columns to a file tagged with a hash of the source they were parsed from, and
+/// `Load` maps such a file back read-only and uses the columns in place, without any fix-up.
+class FlatAST {
+  public:
+    using NodeId                     = uint32_t;
+    static constexpr NodeId NO_NODE  = UINT32_MAX;
+    static constexpr uint8_t NO_TYPE = UINT8_MAX;
+
+    /// @brief Flattens `program`, whose tokens point into `source` and whose types come from
+    /// `typeContext`
+    FlatAST(Program *program, llvm::StringRef source, TypeContext &typeContext);
+    ~FlatAST();
+
+    /// @brief Writes the tree to `path`, tagged with a hash of `source`
+    std::error_code Save(llvm::StringRef path, llvm::StringRef source) const;
+
+    /// @brief Maps the tree saved at `path`
+    /// @details Returns nullptr when the file is missing, malformed, or was saved from a source
+    /// other than `source`. The returned tree refers to `source` for token spellings and hands out
+    /// types from `typeContext`.
+    static std::unique_ptr<FlatAST> Load(llvm::StringRef path, llvm::StringRef source,
+                                         TypeContext &typeContext);
+
+    size_t GetNodeCount() const {
+        return kinds.size();
+    }
+
+    /// @brief Returns the top-level statements, in source order
+    llvm::ArrayRef<NodeId> GetStmts() const {
+        return stmts;
+    }
+
+    ASTNode::Nodekind GetKind(NodeId id) const {
+        return static_cast<ASTNode::Nodekind>(kinds[id]);
+    }
+
+    /// @brief Returns the node's `cType`, or nullptr
+    CType *GetType(NodeId id) const;
+
+    int64_t GetData(NodeId id) const {
+        return data[id];
+    }
+
+    /// @brief Returns true for the kinds whose data column holds a `Symbol` slot
+    static bool HasSlot(ASTNode::Nodekind kind) {
+        return kind == ASTNode::ND_VariableDecl || kind == ASTNode::ND_VariableAssessExpr ||
+               kind == ASTNode::ND_AssignExpr;
+    }
+
+    /// @brief Returns one more than the largest `Symbol` slot in the tree
+    size_t GetSlotCount() const {
+        return slotCount;
+    }
+
+    llvm::ArrayRef<NodeId> GetChildren(NodeId id) const {
+        return children.slice(childBegin[id], childBegin[id + 1] - childBegin[id]);
+    }
+
+    /// @brief Returns the spelling of the node's token
+    llvm::StringRef GetSpelling(NodeId id) const {
+        return llvm::StringRef(bufStart + tokOffsets[id], tokLengths[id]);
+    }
+
+    /// @brief Returns the number of bytes held by the columns
+    size_t GetBytesAllocated() const {
+        return kinds.size() * sizeof(uint8_t) + types.size() * sizeof(uint8_t) +
+               data.size() * sizeof(int64_t) + tokOffsets.size() * sizeof(uint32_t) +
+               tokLengths.size() * sizeof(uint16_t) + childBegin.size() * sizeof(uint32_t) +
+               children.size() * sizeof(NodeId) + stmts.size() * sizeof(NodeId);
+    }
+
+  private:
+    FlatAST(const char *bufStart, TypeContext &typeContext);
+
+    /// @brief Points the column views at `storage`
+    void AttachStorage();
+
+    /// @brief Checks that every index in the columns is in range, e.g. after loading from disk
+    bool IsWellFormed(size_t sourceSize) const;
+
+  private:
+    const char *bufStart;
+    TypeContext &typeContext;
+    size_t slotCount;
+
+    /// Column views; they point either into `storage` or into `mapping`.
+    llvm::ArrayRef<uint8_t> kinds;
+    llvm::ArrayRef<uint8_t> types;
+    llvm::ArrayRef<int64_t> data;
+    llvm::ArrayRef<uint32_t> tokOffsets;
+    llvm::ArrayRef<uint16_t> tokLengths;
+    llvm::ArrayRef<uint32_t> childBegin;
+    llvm::ArrayRef<NodeId> children;
+    llvm::ArrayRef<NodeId> stmts;
+
+    /// @brief Columns of a tree built in memory
+    struct Storage {
+        std::vector<uint8_t> kinds;
+        std::vector<uint8_t> types;
+        std::vector<int64_t> data;
+        std::vector<uint32_t> tokOffsets;
+        std::vector<uint16_t> tokLengths;
+        std::vector<uint32_t> childBegin;
+        std::vector<NodeId> children;
+        std::vector<NodeId> stmts;
+    } storage;
+
+    /// @brief File the columns of a loaded tree live in
+    std::unique_ptr<llvm::sys::fs::mapped_file_region> mapping;
+
+    friend class FlatASTBuilder;
+};
+
+#endif // _FLATAST_H_
@@ -0,0 +1,51 @@
+#pragma once
+#ifndef _IDENTIFIERTABLE_H_
+#define _IDENTIFIERTABLE_H_
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Allocator.h"
+#include <cstdint>
+#include <vector>
+
+/// @brief Dense number of an interned identifier; see `IdentifierTable`
+using IdentId = uint32_t;
+
+/// @brief Interns identifier spellings and numbers them densely.
+/// @details The lexer interns every identifier once, so later passes compare and index identifiers
+/// by `IdentId` instead of hashing their spelling again: tables keyed by identifier become plain
+/// vectors indexed by id. Ids are handed out in order of first appearance starting at 1;
+/// `NO_IDENT` (0) marks tokens that are not identifiers.
+///
+/// Lookups probe an open-addressing table of ids, comparing the full hash of a spelling before its
+/// bytes, and the spellings are copied into a bump allocator owned by the table.
+class IdentifierTable {
+  public:
+    static constexpr IdentId NO_IDENT = 0;
+
+    IdentifierTable();
+
+    /// @brief Returns the id of `name`, numbering it if it was not seen before
+    IdentId Intern(llvm::StringRef name);
+
+    /// @brief Returns the spelling of `id`; it lives as long as the table
+    llvm::StringRef GetName(IdentId id) const {
+        return names[id];
+    }
+
+    /// @brief Returns one more than the largest id handed out so far
+    size_t GetIdCount() const {
+        return names.size();
+    }
+
+  private:
+    /// @brief Doubles `slots` and reinserts every id
+    void Grow();
+
+  private:
+    std::vector<IdentId> slots;         ///< Open-addressing table; `NO_IDENT` marks a free slot
+    std::vector<llvm::StringRef> names; ///< Spelling of each id
+    std::vector<uint64_t> hashes;       ///< Hash of each id's spelling
+    llvm::BumpPtrAllocator nameStorage;
+};
+
+#endif // _IDENTIFIERTABLE_H_
@@ -0,0 +1,63 @@
+#pragma once
+#ifndef _JIT_H_
+#define _JIT_H_
+
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Target/TargetMachine.h"
+#include <memory>
+#include <string>
+
+/// @brief Compiles modules for the host in process with ORC's `LLJIT` and runs them.
+/// @details The target machine is detected from the host, CPU features included, so the code is
+/// as good as what -c produces for this machine. Symbols the modules do not define, such as
+/// `printf`, are resolved against the running process.
+///
+/// Modules added later can use the symbols of earlier ones, which is how the REPL keeps its
+/// variables. Such modules may be created in the JIT's own context, so they need none of their own.
+class JIT {
+  public:
+    /// @brief Creates the JIT for the host
+    /// @param optLevel 0 to 3, applied to both the optimizer and the code generator
+    /// @details Returns nullptr and sets `error` when the host target is not linked in.
+    static std::unique_ptr<JIT> CreateForHost(unsigned optLevel, std::string &error);
+
+    /// @brief Optimizes `module` for the host and hands it to the JIT along with its context
+    /// @details The module is compiled lazily, on the first lookup of one of its symbols.
+    bool AddModule(std::unique_ptr<llvm::LLVMContext> context, std::unique_ptr<llvm::Module> module,
+                   std::string &error);
+
+    /// @brief Same as above for a module created in `GetContext()`
+    bool AddModule(std::unique_ptr<llvm::Module> module, std::string &error);
+
+    /// @brief Returns the context shared by the modules added without one of their own
+    llvm::LLVMContext &GetContext() {
+        return *sharedContext.getContext();
+    }
+
+    /// @brief Looks up `name`, a function taking nothing and returning int, and calls it
+    bool Call(llvm::StringRef name, int &result, std::string &error);
+
+    /// @brief Removes the module added last, with everything compiled from it
+    /// @details Lets the REPL drop a statement that failed to link, so its symbols do not linger.
+    void RemoveLastModule();
+
+  private:
+    bool AddModule(llvm::orc::ThreadSafeModule module, std::string &error);
+
+  private:
+    JIT(std::unique_ptr<llvm::orc::LLJIT> lljit, std::unique_ptr<llvm::TargetMachine> targetMachine,
+        unsigned optLevel)
+        : lljit(std::move(lljit)), targetMachine(std::move(targetMachine)), optLevel(optLevel) {
+    }
+
+  private:
+    std::unique_ptr<llvm::orc::LLJIT> lljit;
+    /// Same target as the JIT's own, only used to tell the optimizer about the host
+    std::unique_ptr<llvm::TargetMachine> targetMachine;
+    unsigned optLevel;
+    llvm::orc::ResourceTrackerSP lastModule; ///< Owns what was compiled from the last module
+    llvm::orc::ThreadSafeContext sharedContext{std::make_unique<llvm::LLVMContext>()};
+};
+
+#endif // _JIT_H_
@@ -2,12 +2,15 @@
 #ifndef _LEXER_H_
 #define _LEXER_H_
 
-#include "CType.h"
 #include "Diagnostics.h"
+#include "IdentifierTable.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/raw_ostream.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
 
-enum class TokenType {
+enum class TokenType : uint8_t {
     Unknown = 0,
     Number,      ///< literal number
     Equal,       ///< =
@@ -22,88 +25,151 @@ enum class TokenType {
     Comma,       ///< ,
     Semi,        ///< ;
     Identifier,  ///< variable name
-    KW_int,      ///< int
-    KW_if,       ///< if
-    KW_else,     ///< else
-    Eof          ///< end of file
+#define KEYWORD(SPELLING, TOKEN) TOKEN,
+#include "../inc/Keywords.inc"
+    Eof ///< end of file
 };
 
-/// @brief Represents a token with its position, type, and value
-/// @details The Token class stores information about a specific token including its position (row
-/// and column), the type of the token (TokenType), and an associated value. This class is used for
-/// lexical analysis in a compiler.
+/// @brief Represents a token with its type and spelling
+/// @details A token only records where its spelling starts in the source buffer, how long it is,
+/// its TokenType and, for identifiers, the id the lexer interned the spelling as. That keeps it at
+/// 16 bytes for the token buffer and for every AST node that embeds one. The literal value and the
+/// row/column are derived from the spelling on demand.
 class Token {
   public:
-    TokenType tokenTy;
-    int row;
-    int col;         ///< The line and column number of the token in the source code.
-    int value;       ///< The value of the token, used when the TokenType is 'number'.
-    CType *cType;    ///< Build-in Type for token (int | )
-    const char *ptr; ///< Diag info pointer
-    int length;      ///< Length of token
+    const char *ptr;   ///< Start of the token spelling in the source buffer
+    uint16_t length;   ///< Length of token
+    TokenType tokenTy; ///< Kind of token
+    IdentId identId;   ///< Interned spelling of an `Identifier`, `NO_IDENT` otherwise
 
   public:
-    Token() {
-        row     = -1;
-        col     = -1;
-        tokenTy = TokenType::Unknown;
-        value   = 0;
+    Token()
+        : ptr(nullptr), length(0), tokenTy(TokenType::Unknown),
+          identId(IdentifierTable::NO_IDENT) {
     }
 
-    Token(TokenType ty, int row, int col) : tokenTy(ty), row(row), col(col) {
+    Token(TokenType ty, const char *ptr, uint16_t length)
+        : ptr(ptr), length(length), tokenTy(ty), identId(IdentifierTable::NO_IDENT) {
     }
 
     static llvm::StringRef GetSpellingText(TokenType ty);
 
-    void setMember(TokenType tokTy, const char *pos, int len, int val = 0, CType *cTy = nullptr) {
+    void setMember(TokenType tokTy, const char *pos, uint16_t len) {
         tokenTy = tokTy;
-        value   = val;
-        cType   = cTy;
         ptr     = pos;
         length  = len;
+        identId = IdentifierTable::NO_IDENT;
     }
 
-    void Dump() {
-        llvm::outs() << "[ " << llvm::StringRef(ptr, length) << ", row = " << row
-                     << ", col = " << col << " ]\n";
+    llvm::StringRef GetText() const {
+        return llvm::StringRef(ptr, length);
+    }
+
+    /// @brief Computes the value of a `Number` token from its digits
+    /// @details Returns false when the value does not fit in 64 bits.
+    bool GetValue(uint64_t &value) const;
+
+    /// @brief Returns the letters that end a `Number` token, such as "ul", or "" if there are none
+    llvm::StringRef GetSuffix() const;
+
+    /// @brief Returns the 1-based (row, column) of the token
+    std::pair<unsigned, unsigned> GetRowCol(Diagnostics &diager) const;
+
+    void Dump(Diagnostics &diager) const {
+        auto [row, col] = GetRowCol(diager);
+        llvm::outs() << "[ " << GetText() << ", row = " << row << ", col = " << col << " ]\n";
     }
 };
+static_assert(sizeof(Token) <= 16, "Token is copied into every AST node, keep it small");
 
 /// @brief Represents a lexer that tokenizes source code into a sequence of tokens
 /// @details The `Lexer` class is responsible for tokenizing the input source code. It processes the
 /// source code character by character, recognizing patterns such as keywords, operators, literals,
-/// and identifiers, and generates the corresponding tokens. The class also tracks the current
-/// position in the source code (row and column) to aid in error reporting and debugging. This class
-/// is an essential component of the lexical analysis phase in a compiler, where the source code is
-/// divided into meaningful symbols for further parsing and compilation.
+/// and identifiers, and generates the corresponding tokens. Tokens only record their position as a
+/// pointer into the source buffer; rows and columns are recovered through `Diagnostics` when a
+/// diagnostic or a dump needs them. This class is an essential component of the lexical analysis
+/// phase in a compiler, where the source code is divided into meaningful symbols for further
+/// parsing and compilation.
+///
+/// Identifiers are interned into an `IdentifierTable` as they are lexed and their tokens carry the
+/// resulting id. The lexer owns its table unless it is handed one to share with other lexers.
 class Lexer {
+  public:
+    /// Inputs smaller than this are always lexed on the calling thread.
+    static constexpr size_t PARALLEL_THRESHOLD = 8 * 1024 * 1024;
+
   public:
     Lexer(llvm::SourceMgr &mgr, Diagnostics &diager);
+
+    /// @brief Creates a lexer that interns identifiers into `identifiers`
+    Lexer(llvm::SourceMgr &mgr, Diagnostics &diager, IdentifierTable &identifiers);
+
+    /// @brief Same as above, lexing buffer `bufferId` of `mgr` instead of its main file
+    Lexer(llvm::SourceMgr &mgr, Diagnostics &diager, IdentifierTable &identifiers,
+          unsigned bufferId);
+
     void NextToken(Token &tok);
     void Run(Token &tok);
-    void SaveState();
-    void RestoreState();
     Diagnostics &GetDiagnostics();
 
+    /// @brief Returns the table the identifiers lexed so far were interned into
+    IdentifierTable &GetIdentifierTable() {
+        return *identifiers;
+    }
+
+    /// @brief Sets how many threads `LexAll` may use
+    void SetThreadCount(unsigned count);
+
+    /// @brief Returns true when the rest of the input is large enough for `LexAll` to split it
+    bool ShouldLexInParallel() const;
+
+    /// @brief Lexes the rest of the input into `tokens`, which ends with the Eof token
+    /// @details The input is cut into one chunk per thread, each cut moved forward to the next
+    /// blank. No token contains a blank, so every chunk can be lexed on its own, and since tokens
+    /// only hold pointers into the buffer no position needs fixing up when the chunks are joined.
+    /// A chunk that hits a lexical error stops; the input is then lexed again on the calling thread
+    /// from the start of that chunk, so the error is reported exactly as `NextToken` would.
+    /// Identifiers are interned on the calling thread while the chunks are joined.
+    void LexAll(std::vector<Token> &tokens);
+
+  private:
+    /// @brief Creates a lexer for [begin, end) of `parent`'s input that reports errors through
+    /// `hasError` and leaves identifiers uninterned
+    Lexer(const Lexer &parent, const char *begin, const char *end);
+
   private:
     llvm::SourceMgr &mgr;
     Diagnostics &diager;
-    struct State {
-        const char *workPtr;
-        const char *workRowHeadPtr;
-        const char *eofPtr;
-        int workRow;
-    };
-    State state;                ///< Record Lexer State for LL(k)
-    const char *workPtr;        ///< Pointer to the current character in the source
-                                ///< code being scanned
-    const char *workRowHeadPtr; ///< Pointer to the start of the current line in
-                                ///< the source code being scanned
-    const char *eofPtr;         ///< Pointer to the end-of-file in the source code being scanned
-    int workRow;                ///< Line number in the source code currently being scanned
+    std::unique_ptr<IdentifierTable> ownIdentifiers; ///< Set unless the table is shared
+    IdentifierTable *identifiers;                    ///< Interned into; nullptr for chunk lexers
+    const char *workPtr;  ///< Pointer to the current character in the source
+                          ///< code being scanned
+    const char *eofPtr;   ///< Pointer to the end-of-file in the source code being scanned
+    unsigned threadCount; ///< Threads `LexAll` may use
+    bool deferErrors;     ///< Record lexical errors in `hasError` instead of reporting them
+    bool hasError;        ///< A lexical error was found while `deferErrors` was set
 
   private:
+    /// @brief Lexes [begin, end) into `tokens` without the trailing Eof; returns false on error
+    bool LexChunk(const char *begin, const char *end, std::vector<Token> &tokens);
+
     void KeyWordHandle(Token &tok);
+
+    /// @brief Skips blanks before the next token.
+    /// @details Uses SSE2/AVX2 to classify a whole block per step when available (see
+    /// `LEXER_DISABLE_SIMD`); otherwise falls back to scanning byte by byte.
+    void SkipWhiteSpace();
+
+    /// @brief Returns the length of the token spanning [tokenStart, workPtr), reporting spellings
+    /// too long for `Token::length`.
+    uint16_t TokenLength(const char *tokenStart);
+
+    /// @brief Returns the first position at or after `ptr` that is not a digit.
+    const char *ScanDigits(const char *ptr);
+
+    /// @brief Returns the first position at or after `ptr` that is not an identifier letter.
+    const char *ScanLetters(const char *ptr);
+
     bool IsWhiteSpace(char ch);
     bool IsDigit(char ch);
     bool IsLetter(char ch);
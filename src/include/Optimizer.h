@@ -0,0 +1,31 @@
+#pragma once
+#ifndef _OPTIMIZER_H_
+#define _OPTIMIZER_H_
+
+#include "llvm/IR/Module.h"
+#include "llvm/Target/TargetMachine.h"
+
+/// @brief Runs LLVM's default optimization pipeline of an `-O` level over a module.
+/// @details The pipeline is built by the new pass manager's `PassBuilder`, which for the levels
+/// above 0 includes mem2reg (as SROA), instcombine, GVN and SimplifyCFG, among others. Level 0 runs
+/// nothing, so the module keeps the naive alloca form CodeGen emits.
+///
+/// Pass instrumentation is registered as well, so LLVM's own `-time-passes` option reports the
+/// time spent in each pass once the pipeline has run.
+class Optimizer {
+  public:
+    /// @param level 0 to 3, as in -O0 to -O3
+    /// @param targetMachine when given, passes query it for the target's costs and features
+    Optimizer(unsigned level, llvm::TargetMachine *targetMachine = nullptr)
+        : level(level), targetMachine(targetMachine) {
+        assert(level <= 3 && "no such optimization level");
+    }
+
+    void Run(llvm::Module &module);
+
+  private:
+    unsigned level;
+    llvm::TargetMachine *targetMachine;
+};
+
+#endif // _OPTIMIZER_H_
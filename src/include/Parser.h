@@ -5,14 +5,17 @@
 #include "Ast.h"
 #include "Lexer.h"
 #include "Sema.h"
+#include "TokenStream.h"
 
 /// @brief Syntax analyzer that uses recursive descent to parse input tokens into C language syntax
-/// @details The current grammar rules are as follows:
+/// @details Statements are parsed by recursive descent; expressions by precedence climbing over the
+/// operator table in Parser.cpp. The current grammar rules are as follows:
 /// +-----------------------------------------------------+
 /// | prog            : stmt*
 /// | stmt            : decl-stmt | expr-stmt | null-stmt | if-stmt | block-stmt
 /// | null-stmt       : ";"
-/// | decl-stmt       : "int" identifier ("=" expr)? ("," identifier ("=" expr)?)* ";"
+/// | decl-stmt       : decl-spec identifier ("=" expr)? ("," identifier ("=" expr)?)* ";"
+/// | decl-spec       : ("char" | "short" | "int" | "long" | "signed" | "unsigned")+
 /// | expr-stmt       : expr ";"
 /// | if-stmt         : "if" "(" expr ")" "{" stmt  "}" ("else" "{" stmt "}")?
 /// | block-stmt      : "{" stmt* "}"
@@ -28,23 +31,31 @@
 class Parser {
   public:
     Parser(Lexer &lex, Sema &sema);
-    std::shared_ptr<Program> ParserProgram();
+    Program *ParserProgram();
+
+    /// @brief Parses the next top-level statement
+    /// @details Returns nullptr for a null statement. Together with `IsAtEof` this lets the caller
+    /// consume the program one statement at a time instead of building a whole `Program`.
+    ASTNode *ParserTopLevelStmt();
+
+    /// @brief Returns true once every statement of the input has been parsed
+    bool IsAtEof() const {
+        return token.tokenTy == TokenType::Eof;
+    }
 
   private:
     Lexer &lexer;
+    TokenStream tokenStream; ///< Lookahead buffer over `lexer`
     Sema &sema;
     Token token; ///< The current token
 
   private:
-    std::shared_ptr<ASTNode> ParserStmt();
-    std::shared_ptr<ASTNode> ParserDeclStmt();
-    std::shared_ptr<ASTNode> ParserBlockStmt();
-    std::shared_ptr<ASTNode> ParserExprStmt();
-    std::shared_ptr<ASTNode> ParserIfStmt();
-    std::shared_ptr<ASTNode> ParserExpr();
-    std::shared_ptr<ASTNode> ParserAssignExpr();
-    std::shared_ptr<ASTNode> ParserTerm();
-    std::shared_ptr<ASTNode> ParserFactor();
+    ASTNode *ParserStmt();
+    ASTNode *ParserDeclStmt();
+    CType *ParserDeclSpec();
+    ASTNode *ParserExprStmt();
+    ASTNode *ParserExpr();
+    ASTNode *ParserPrimaryExpr();
 
   private:
     /// @brief Checks if the current token is the expected token without consuming it
@@ -1,20 +1,19 @@
 #pragma once
 #ifndef _PRINTVISITOR_H_
 #define _PRINTVISITOR_H_
+#include "ASTWalker.h"
 #include "Ast.h"
 
-class PrintVisitor : public Visitor {
+class PrintVisitor : public ASTWalker<PrintVisitor> {
   public:
-    PrintVisitor(std::shared_ptr<Program> program);
-    llvm::Value *VisitProgram(Program *program) override;
-    llvm::Value *VisitDeclStmts(DeclStmts *declStmts) override;
-    llvm::Value *VisitVariableDecl(VariableDecl *VariableDecl) override;
-    llvm::Value *VisitIfStmt(IfStmt *ifStmt) override;
-    llvm::Value *VisitBlockStmts(BlockStmts *blockStmts);
-    llvm::Value *VisitBinaryExpr(BinaryExpr *binaryExpr) override;
-    llvm::Value *VisitNumberExpr(NumberExpr *numberExpr) override;
-    llvm::Value *VisitVariableAssessExpr(VariableAssessExpr *variableAssessExpr) override;
-    llvm::Value *VisitAssignExpr(AssignExpr *assignExpr) override;
+    PrintVisitor(Program *program);
+    void VisitProgram(Program *program);
+
+  private:
+    friend class ASTWalker<PrintVisitor>;
+    void PreVisit(ASTNode *node);
+    bool InVisit(ASTNode *node, unsigned childIdx);
+    void PostVisit(ASTNode *node);
 };
 
 #endif // _PRINTVISITOR_H_
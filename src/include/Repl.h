@@ -0,0 +1,69 @@
+#pragma once
+#ifndef _REPL_H_
+#define _REPL_H_
+
+#include "ASTContext.h"
+#include "CodeGen.h"
+#include "Diagnostics.h"
+#include "IdentifierTable.h"
+#include "JIT.h"
+#include "Sema.h"
+#include "llvm/Support/SourceMgr.h"
+#include <istream>
+#include <memory>
+#include <string>
+
+/// @brief Reads statements interactively and runs each one as soon as it is complete.
+/// @details One `Sema`, and with it one `Scope`, and one JIT session live for the whole session.
+/// Every input is added to the `SourceMgr` as a buffer of its own and lexed with the shared
+/// `IdentifierTable`, so names declared earlier resolve as in a single file.
+///
+/// Each top-level statement is generated into a module of its own, holding a function that runs
+/// the statement and prints its value. Variables are JIT-visible globals, so later statements
+/// reach them through the JIT's symbol table. Nothing about earlier statements is compiled again,
+/// and the time from a line to its value does not grow with the length of the session.
+///
+/// Input is collected until its braces balance and it ends in ';' or '}', so an if-statement or
+/// a block may span several lines; an `else` must follow its closing brace on the same line.
+///
+/// Errors do not end the session. Diagnostics are made recoverable, and a statement that fails is
+/// forgotten: the scopes and symbols it opened are rolled back, the rest of its input is dropped
+/// and its module, if it got one, is removed from the JIT. Everything before it stays.
+class Repl {
+  public:
+    /// @brief Creates the JIT; returns nullptr and sets `error` when that fails
+    /// @param optLevel 0 to 3, as in -O0 to -O3
+    static std::unique_ptr<Repl> Create(unsigned optLevel, bool shareExprs, std::string &error);
+
+    /// @brief Reads and runs statements from `in` until it ends
+    /// @details Returns 0, or -1 when any statement failed, for the sake of piped input.
+    int Run(std::istream &in);
+
+    /// @brief Returns the JIT the statements run in, e.g. to define symbols ahead of them
+    JIT &GetJIT() {
+        return *jit;
+    }
+
+  private:
+    Repl(std::unique_ptr<JIT> jit, bool shareExprs);
+
+    /// @brief Lexes, parses and runs the statements of one complete input, up to the first that
+    /// fails; returns false if one did
+    bool RunInput(const std::string &input);
+
+    /// @brief Compiles `stmt` into a module of its own and runs it
+    /// @details A module that can not be linked is removed from the JIT again.
+    bool RunStmt(ASTNode *stmt);
+
+  private:
+    llvm::SourceMgr mgr;
+    Diagnostics diag{mgr};
+    IdentifierTable identifiers;
+    ASTContext astContext;
+    Sema sema{diag, astContext};
+    std::unique_ptr<JIT> jit;
+    CodeGen codeGen; ///< Emits into the JIT's context; declared after `jit` to be destroyed first
+    unsigned stmtCount = 0;
+};
+
+#endif // _REPL_H_
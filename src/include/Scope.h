@@ -3,8 +3,10 @@
 #define _SCOPE_H_
 
 #include "CType.h"
-#include "llvm/ADT/StringMap.h"
-#include <memory>
+#include "IdentifierTable.h"
+#include "llvm/Support/Allocator.h"
+#include <cstdint>
+#include <vector>
 
 enum class SymbolKind {
     LocalVariable = 0,
@@ -13,36 +15,90 @@ enum class SymbolKind {
 /// @brief Represents a symbol in C language.
 /// @details This class is used to describe a symbol in the program, such as variables, functions,
 /// or other named entities. Each symbol is associated with a name, a kind, and a type.
+///
+/// Symbols are owned by the `Scope` that declared them and stay valid until that `Scope` is
+/// destroyed, even after the block declaring them has been closed.
 class Symbol {
   public:
-    Symbol(llvm::StringRef name, SymbolKind symbolKind, CType *cType)
-        : name(name), symbolKind(symbolKind), cType(cType) {
+    Symbol(IdentId id, llvm::StringRef name, SymbolKind symbolKind, CType *cType)
+        : cType(cType), id(id), name(name), symbolKind(symbolKind) {
     }
     CType *cType;
+    uint64_t version = 0; ///< Bumped on every write while Sema shares expressions
+
+    IdentId GetId() const {
+        return id;
+    }
+
+    /// @brief Returns the dense number of the symbol among all symbols of its `Scope`
+    /// @details CodeGen keeps the storage of the variable at this index.
+    unsigned GetSlot() const {
+        return slot;
+    }
+
+    llvm::StringRef GetName() const {
+        return name;
+    }
 
   private:
+    IdentId id;
     llvm::StringRef name;
     SymbolKind symbolKind;
-};
+    unsigned slot    = 0;
+    unsigned depth   = 0;       ///< Nesting depth of the scope that declared the symbol
+    Symbol *shadowed = nullptr; ///< Binding of the same name this one hides, if any
 
-class Env {
-  public:
-    llvm::StringMap<std::shared_ptr<Symbol>> variableSymbolTable;
+    friend class Scope;
 };
 
-/// @brief Represents an environment for managing symbols.
-/// @details This class contains a symbol table for storing and accessing variable symbols.
+/// @brief Scoped symbol table.
+/// @details A single table indexed by `IdentId` holds every identifier's innermost visible binding,
+/// and each binding links to the one it shadows. Declaring a symbol appends it to an undo log;
+/// leaving a scope pops that scope's part of the log and restores the shadowed bindings. Lookups
+/// therefore cost one array access regardless of how deeply scopes are nested, with no hashing,
+/// and symbols are bump-allocated without any reference counting.
 class Scope {
   public:
+    /// @brief Scopes open and symbols visible at some point, to roll back to with `Rollback`
+    struct Checkpoint {
+        size_t scopes;
+        size_t symbols;
+    };
+
     Scope();
     void EnterScope();
     void ExitScope();
-    void AddSymbol(llvm::StringRef name, SymbolKind symbolKind, CType *cType);
-    std::shared_ptr<Symbol> FindVarSymbol(llvm::StringRef name);
-    std::shared_ptr<Symbol> FindVarSymbolInCurrEnv(llvm::StringRef name);
+
+    Checkpoint GetCheckpoint() const {
+        return {scopeStarts.size(), undoLog.size()};
+    }
+
+    /// @brief Closes the scopes entered and hides the symbols declared since `checkpoint`
+    /// @details Used to forget a statement that failed halfway through. Slots are not reused.
+    void Rollback(Checkpoint checkpoint);
+
+    /// @brief Declares identifier `id` in the innermost scope
+    /// @details `name` is only kept for diagnostics and must outlive the symbol.
+    Symbol *AddSymbol(IdentId id, llvm::StringRef name, SymbolKind symbolKind, CType *cType);
+
+    /// @brief Returns the innermost visible symbol for identifier `id`, or nullptr
+    Symbol *FindVarSymbol(IdentId id) const {
+        return id < bindings.size() ? bindings[id] : nullptr;
+    }
+
+    /// @brief Returns the symbol for identifier `id` declared in the innermost scope, or nullptr
+    Symbol *FindVarSymbolInCurrEnv(IdentId id) const;
+
+  private:
+    /// @brief Pops the undo log down to `size` entries, restoring the shadowed bindings
+    void PopSymbols(size_t size);
 
   private:
-    std::vector<std::shared_ptr<Env>> envs;
+    std::vector<Symbol *> bindings;  ///< Innermost binding per id; nullptr when none is visible
+    std::vector<Symbol *> undoLog;   ///< Declared symbols that are still visible, in order
+    std::vector<size_t> scopeStarts; ///< `undoLog` size when each open scope was entered
+    unsigned symbolCount = 0;        ///< Symbols declared so far; the next symbol's slot
+    llvm::BumpPtrAllocator symbolPool;
 };
 
-#endif // _SCOPE_H_
\ No newline at end of file
+#endif // _SCOPE_H_
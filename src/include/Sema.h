@@ -2,45 +2,103 @@
 #ifndef _SEMA_H_
 #define _SEMA_H_
 
+#include "ASTContext.h"
 #include "Ast.h"
 #include "Lexer.h"
 #include "Scope.h"
+#include "llvm/ADT/DenseMap.h"
+#include <tuple>
 
 /// @brief Performs semantic analysis for the program.
 /// @details The `Sema` class is responsible for performing semantic analysis on Abstract Syntax
 /// Tree (AST) nodes. It validates and processes various constructs in the program, such as variable
 /// declarations, expressions, and operations. It ensures that the program adheres to semantic rules
 /// and prepares the AST for further compilation stages.
+///
+/// Binary expressions over two `int` numbers are folded into a `NumberExpr`, and an if-statement
+/// whose condition is a number is replaced by the branch that is taken, so most constant subtrees
+/// never reach CodeGen.
+///
+/// With expression sharing enabled, pure expressions (numbers, variable reads and arithmetic on
+/// them) are hash-consed: building an expression that is structurally identical to one built
+/// earlier returns the earlier node and marks it `isShared`. A variable read is keyed by the
+/// variable's current version, which every write replaces with a fresh one, so two reads only
+/// share a node when no write to the variable was parsed between them.
 class Sema {
   public:
-    std::shared_ptr<ASTNode> SemaBlockStmtNode(std::shared_ptr<ASTNode> condExpr,
-                                               std::shared_ptr<ASTNode> thenStmt,
-                                               std::shared_ptr<ASTNode> elseStmt);
-
-    std::shared_ptr<ASTNode> SemaIfStmtNode(std::shared_ptr<ASTNode> condExpr,
-                                            std::shared_ptr<ASTNode> thenStmt,
-                                            std::shared_ptr<ASTNode> elseStmt);
+    Sema(Diagnostics &diager, ASTContext &context) : diager(diager), context(context) {
+    }
 
-    Sema(Diagnostics &diager) : diager(diager) {
+    ASTContext &GetASTContext() {
+        return context;
     }
-    std::shared_ptr<ASTNode> SemaVariableDeclNode(CType *cType, Token &tok);
 
-    std::shared_ptr<ASTNode>
-    SemaAssignExprNode(std::shared_ptr<ASTNode> left, std::shared_ptr<ASTNode> right, Token tok);
+    ASTNode *SemaDeclStmtNode(llvm::ArrayRef<ASTNode *> nodeVec);
+
+    ASTNode *SemaBlockStmtNode(llvm::ArrayRef<ASTNode *> nodeVec);
+
+    ASTNode *SemaIfStmtNode(ASTNode *condExpr, ASTNode *thenStmt, ASTNode *elseStmt);
+
+    ASTNode *SemaVariableDeclNode(CType *cType, Token &tok);
 
-    std::shared_ptr<ASTNode> SemaVariableAccessExprNode(Token &tok);
+    ASTNode *SemaAssignExprNode(ASTNode *left, ASTNode *right, Token tok);
 
-    std::shared_ptr<ASTNode>
-    SemaBinaryExprNode(std::shared_ptr<ASTNode> left, OpCode op, std::shared_ptr<ASTNode> right);
+    ASTNode *SemaVariableAccessExprNode(Token &tok);
 
-    std::shared_ptr<ASTNode> SemaNumberExprNode(CType *cType, Token &tok);
+    ASTNode *SemaBinaryExprNode(ASTNode *left, OpCode op, ASTNode *right, Token tok);
+
+    /// @brief Types the literal as C does: the first of `int`, `long` and `long long` that holds
+    /// its value, starting at `long` or `long long` for an "l" or "ll" suffix, and of their
+    /// unsigned variants for a "u" suffix. A literal no candidate holds is an error.
+    ASTNode *SemaNumberExprNode(Token &tok);
 
     void EnterScope();
     void ExitScope();
 
+    Scope::Checkpoint GetScopeCheckpoint() const {
+        return scope.GetCheckpoint();
+    }
+
+    /// @brief Forgets the scopes and symbols of a statement that failed; see `Scope::Rollback`
+    void RollbackScope(Scope::Checkpoint checkpoint) {
+        scope.Rollback(checkpoint);
+    }
+
+    /// @brief Enables or disables expression sharing for the nodes built from now on
+    void SetExprSharing(bool enable) {
+        shareExprs = enable;
+    }
+
+    /// @brief Forgets every shared expression; required whenever the `ASTContext` is reset
+    void ForgetSharedExprs() {
+        sharedExprs.clear();
+    }
+
+  private:
+    /// @brief Returns a `NumberExpr` of `value`, shared like any other when sharing is enabled
+    ASTNode *CreateNumberExpr(CType *cType, int64_t value, Token tok);
+
+    /// @brief Computes `left op right` into `value` the way the generated code would
+    /// @details Signed overflow is reported and folds to the wrapped result. A division by zero or
+    /// of `INT_MIN` by -1 is reported and not folded. `tok` is the operator, for diagnostics.
+    bool FoldBinaryExpr(int left, OpCode op, int right, Token tok, int &value);
+
+    /// @brief Kind, value/opcode/version, and the operands (or the symbol) of a pure expression
+    using SharedExprKey = std::tuple<unsigned, int64_t, const void *, const void *>;
+
+    /// @brief Returns the node already built for `key` and marks it shared, or nullptr
+    ASTNode *FindSharedExpr(const SharedExprKey &key);
+
+    /// @brief Gives `symbol` a version no earlier read was keyed with
+    void RecordWrite(Symbol *symbol);
+
   private:
     Scope scope;
     Diagnostics &diager;
+    ASTContext &context;
+    bool shareExprs     = false;
+    uint64_t writeClock = 0; ///< Source of fresh variable versions
+    llvm::DenseMap<SharedExprKey, ASTNode *> sharedExprs;
 };
 
 #endif // _SEMA_H_
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+#ifndef _TOKENSTREAM_H_
+#define _TOKENSTREAM_H_
+
+#include "Lexer.h"
+#include <vector>
+
+/// @brief Buffers the tokens produced by a `Lexer` so the parser can look ahead any distance.
+/// @details Every token is lexed exactly once, on the first `Peek`/`Next` that reaches it. Tokens
+/// the parser has consumed are dropped from the front of the buffer once they make up at least
+/// half of it, so the buffer only grows with the lookahead actually used, not with the input size.
+///
+/// When the lexer is allowed several threads and the input is large enough, the whole input is
+/// lexed up front with `Lexer::LexAll` instead.
+class TokenStream {
+  public:
+    TokenStream(Lexer &lex);
+
+    /// @brief Returns the `k`-th token that has not been consumed yet, `Peek(0)` being the next one
+    /// @details The reference is invalidated by the next call to `Peek` or `Next`. Peeking past the
+    /// end of input returns the `Eof` token.
+    const Token &Peek(unsigned k = 0);
+
+    /// @brief Consumes the next token and returns it
+    Token Next();
+
+  private:
+    Lexer &lexer;
+    std::vector<Token> tokens; ///< Lexed tokens; [pos, size) have not been consumed yet
+    size_t pos;                ///< Index of the next token to hand out
+
+  private:
+    /// @brief Lexes until the buffer holds at least `count` unconsumed tokens or reaches Eof
+    void Fill(size_t count);
+};
+
+#endif // _TOKENSTREAM_H_
@@ -0,0 +1,67 @@
+#pragma once
+#ifndef _TYPECONTEXT_H_
+#define _TYPECONTEXT_H_
+
+#include "CType.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/Support/Allocator.h"
+#include <utility>
+
+/// @brief Creates and owns every `CType` of a translation unit.
+/// @details Each type exists once per context: the integer types are built up front, and pointer
+/// and array types are hash-consed on their element type (and length), so comparing two types is a
+/// pointer compare. Types live until the context is destroyed. The sizes and alignments are those
+/// of the LP64 data model.
+///
+/// The context also implements the C integer conversions on its types.
+class TypeContext {
+  public:
+    TypeContext();
+    TypeContext(const TypeContext &)            = delete;
+    TypeContext &operator=(const TypeContext &) = delete;
+
+    /// @brief Returns the integer type of `kind`, which must not be `Pointer` or `Array`
+    CType *GetIntegerType(CTypeKind kind) {
+        return integerTypes[static_cast<unsigned>(kind)];
+    }
+
+    CType *GetIntTy() {
+        return GetIntegerType(CTypeKind::Int);
+    }
+
+    /// @brief Returns the type of a pointer to `pointee`
+    CType *GetPointerType(CType *pointee);
+
+    /// @brief Returns the type of an array of `count` elements of `element`
+    CType *GetArrayType(CType *element, uint64_t count);
+
+    /// @brief Returns the unsigned integer type with the rank of integer type `ty`
+    CType *GetUnsignedType(CType *ty) {
+        return GetIntegerType(static_cast<CTypeKind>(static_cast<unsigned>(ty->GetKind()) | 1));
+    }
+
+    /// @brief Applies the integer promotions: types ranked below `int` become `int`
+    CType *GetPromotedType(CType *ty) {
+        return ty->GetRank() < GetIntTy()->GetRank() ? GetIntTy() : ty;
+    }
+
+    /// @brief Returns the type the usual arithmetic conversions bring integer operands `lhs` and
+    /// `rhs` to, which is also the type of the result
+    CType *GetCommonType(CType *lhs, CType *rhs);
+
+  private:
+    static constexpr unsigned INTEGER_TYPE_COUNT = static_cast<unsigned>(CTypeKind::ULongLong) + 1;
+
+    /// @brief Constructs a `CType` in the context's arena
+    template <typename... Args> CType *Create(Args &&...args) {
+        return new (allocator.Allocate<CType>()) CType(std::forward<Args>(args)...);
+    }
+
+  private:
+    llvm::BumpPtrAllocator allocator;
+    CType *integerTypes[INTEGER_TYPE_COUNT];
+    llvm::DenseMap<CType *, CType *> pointerTypes;
+    llvm::DenseMap<std::pair<CType *, uint64_t>, CType *> arrayTypes;
+};
+
+#endif // _TYPECONTEXT_H_
@@ -1,21 +1,211 @@
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/ErrorOr.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
+#include <iostream>
+#include <thread>
 
+#include "include/Backend.h"
 #include "include/CodeGen.h"
 #include "include/Diagnostics.h"
+#include "include/FlatAST.h"
+#include "include/JIT.h"
 #include "include/Lexer.h"
+#include "include/Optimizer.h"
 #include "include/Parser.h"
 #include "include/PrintVisitor.h"
+#include "include/Repl.h"
 #include "include/Sema.h"
 
+static llvm::cl::opt<std::string> InputFile(llvm::cl::Positional,
+                                            llvm::cl::desc("<input file>"));
+
+static llvm::cl::opt<unsigned>
+    LexThreads("lex-threads",
+               llvm::cl::desc("Threads used to lex inputs larger than 8 MB (0 = one per core)"),
+               llvm::cl::init(0));
+
+static llvm::cl::opt<bool>
+    StreamStmts("stream",
+                llvm::cl::desc("Compile one top-level statement at a time, freeing its AST before "
+                               "parsing the next"),
+                llvm::cl::init(false));
+
+static llvm::cl::opt<bool>
+    EmitAST("emit-ast",
+            llvm::cl::desc("Also write the parsed AST next to the input, as <input file>.ast"),
+            llvm::cl::init(false));
+
+static llvm::cl::opt<bool>
+    LoadAST("load-ast",
+            llvm::cl::desc("Compile from <input file>.ast when it was saved from this very input, "
+                           "skipping lexing, parsing and semantic analysis"),
+            llvm::cl::init(false));
+
+static llvm::cl::opt<bool> ShareExprs(
+    "share-exprs",
+    llvm::cl::desc("Share identical pure expressions between writes and emit each once per block"),
+    llvm::cl::init(false));
+
+static llvm::cl::opt<bool>
+    DirectSSA("ssa",
+              llvm::cl::desc("Build SSA form directly while generating IR instead of emitting an "
+                             "alloca per variable"),
+              llvm::cl::init(false));
+
+static llvm::cl::opt<char>
+    OptLevel("O",
+             llvm::cl::desc("Optimization level: -O0, -O1, -O2 or -O3 (default -O0); combine with "
+                            "-time-passes to time each pass"),
+             llvm::cl::Prefix, llvm::cl::init('0'));
+
+static llvm::cl::opt<bool>
+    CompileOnly("c", llvm::cl::desc("Write an object file, or bitcode with -emit-llvm"),
+                llvm::cl::init(false));
+
+static llvm::cl::opt<bool>
+    AssembleOnly("S", llvm::cl::desc("Write assembly, or textual IR with -emit-llvm"),
+                 llvm::cl::init(false));
+
+static llvm::cl::opt<bool>
+    EmitLLVM("emit-llvm",
+             llvm::cl::desc("With -c or -S, write LLVM IR for the host target instead of native "
+                            "code"),
+             llvm::cl::init(false));
+
+static llvm::cl::opt<std::string>
+    OutputFile("o",
+               llvm::cl::desc("Output file; defaults to the input's name with the output's "
+                              "extension for -c and -S, and to stdout otherwise"),
+               llvm::cl::value_desc("file"));
+
+static llvm::cl::opt<bool>
+    RunJIT("run",
+           llvm::cl::desc("Compile the program for the host in process and run it right away, "
+                          "exiting with its exit code"),
+           llvm::cl::init(false));
+
+static llvm::cl::opt<bool>
+    RunRepl("repl",
+            llvm::cl::desc("Read statements from stdin instead of an input file and run each one "
+                           "as soon as it is complete, printing its value"),
+            llvm::cl::init(false));
+
+/// @brief Returns where the module goes when no -o is given
+static std::string DefaultOutputPath() {
+    if (!CompileOnly && !AssembleOnly) {
+        return "-";
+    }
+    const char *ext = CompileOnly ? (EmitLLVM ? ".bc" : ".o") : (EmitLLVM ? ".ll" : ".s");
+    return (llvm::sys::path::stem(InputFile) + ext).str();
+}
+
+/// @brief Compiles the module with the JIT and returns the exit code of its `main`
+static int RunModule(CodeGen &codeGen) {
+    std::string error;
+    std::unique_ptr<JIT> jit = JIT::CreateForHost(OptLevel - '0', error);
+    if (!jit) {
+        llvm::errs() << "can't create the JIT: " << error << "\n";
+        return -1;
+    }
+    auto [context, module] = codeGen.TakeModule();
+    int exitCode           = 0;
+    if (!jit->AddModule(std::move(context), std::move(module), error) ||
+        !jit->Call("main", exitCode, error)) {
+        llvm::errs() << "can't run the program: " << error << "\n";
+        return -1;
+    }
+    return exitCode;
+}
+
+/// @brief Optimizes the module at the requested level and writes it out in the requested form
+/// @details Without -c or -S the module is written as textual IR for no particular target, as it
+/// always was. Otherwise the module is configured for the host first, so the optimizer knows the
+/// target, and native code is generated in process through its `TargetMachine`. With -run the
+/// module is not written at all but run by the JIT.
+static int EmitModule(CodeGen &codeGen) {
+    if (RunJIT) {
+        return RunModule(codeGen);
+    }
+    llvm::Module *module = codeGen.GetModule();
+    std::unique_ptr<Backend> backend;
+    if (CompileOnly || AssembleOnly) {
+        std::string error;
+        backend = Backend::CreateForHost(OptLevel - '0', error);
+        if (!backend) {
+            llvm::errs() << "can't create the target machine: " << error << "\n";
+            return -1;
+        }
+        backend->ConfigureModule(*module);
+    }
+    Optimizer(OptLevel - '0', backend ? backend->GetTargetMachine() : nullptr).Run(*module);
+
+    std::string path = OutputFile.empty() ? DefaultOutputPath() : OutputFile.getValue();
+    std::error_code ec;
+    llvm::raw_fd_ostream os(path, ec,
+                            CompileOnly ? llvm::sys::fs::OF_None : llvm::sys::fs::OF_Text);
+    if (ec) {
+        llvm::errs() << "can't write file: " << path << ": " << ec.message() << "\n";
+        return -1;
+    }
+    if (!backend || (AssembleOnly && EmitLLVM)) {
+        module->print(os, nullptr);
+    } else if (EmitLLVM) {
+        llvm::WriteBitcodeToFile(*module, os);
+    } else {
+        Backend::FileKind kind =
+            CompileOnly ? Backend::FileKind::Object : Backend::FileKind::Assembly;
+        if (!backend->Emit(*module, kind, os)) {
+            llvm::errs() << "the target can't emit this file type\n";
+            return -1;
+        }
+    }
+    return 0;
+}
+
 int main(int argc, char *argv[]) {
-    if (argc < 2) {
+    llvm::cl::ParseCommandLineOptions(argc, argv, "C compiler based on LLVM IR\n");
+    if (RunRepl && !InputFile.empty()) {
+        llvm::errs() << "-repl reads statements from stdin and takes no input file\n";
+        return -1;
+    }
+    if (RunRepl &&
+        (DirectSSA || StreamStmts || EmitAST || LoadAST || LexThreads.getNumOccurrences())) {
+        llvm::errs() << "-repl cannot be combined with -ssa, -stream, -emit-ast, -load-ast or "
+                        "-lex-threads\n";
+        return -1;
+    }
+    if (InputFile.empty() && !RunRepl) {
         llvm::outs() << "Error " << argv[0] << ": no input file\n";
         return 0;
     }
+    if (OptLevel < '0' || OptLevel > '3') {
+        llvm::errs() << "invalid optimization level: -O" << OptLevel << "\n";
+        return -1;
+    }
+    if (CompileOnly && AssembleOnly) {
+        llvm::errs() << "-c and -S cannot be combined\n";
+        return -1;
+    }
+    if ((RunJIT || RunRepl) && (CompileOnly || AssembleOnly || !OutputFile.empty())) {
+        llvm::errs() << (RunJIT ? "-run" : "-repl")
+                     << " writes no output and cannot be combined with -c, -S or -o\n";
+        return -1;
+    }
+    if (RunRepl) {
+        std::string error;
+        std::unique_ptr<Repl> repl = Repl::Create(OptLevel - '0', ShareExprs, error);
+        if (!repl) {
+            llvm::errs() << "can't create the JIT: " << error << "\n";
+            return -1;
+        }
+        return repl->Run(std::cin);
+    }
 
-    const char *file_name = argv[1];
+    const char *file_name = InputFile.c_str();
     static llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> buf =
         llvm::MemoryBuffer::getFile(file_name);
 
@@ -29,14 +219,63 @@ int main(int argc, char *argv[]) {
     mgr.AddNewSourceBuffer(std::move(*buf), llvm::SMLoc());
 
     // std::unique_ptr<llvm::MemoryBuffer> memBuf = std::move(*buf);
+    llvm::StringRef source = mgr.getMemoryBuffer(mgr.getMainFileID())->getBuffer();
+    std::string astPath    = InputFile + ".ast";
+    if (LoadAST) {
+        TypeContext types;
+        if (std::unique_ptr<FlatAST> flat = FlatAST::Load(astPath, source, types)) {
+            CodeGen codeGen;
+            codeGen.SetDirectSSA(DirectSSA);
+            codeGen.BeginMain();
+            for (FlatAST::NodeId stmt : flat->GetStmts()) {
+                codeGen.EmitStmt(*flat, stmt);
+            }
+            codeGen.FinishMain();
+            return EmitModule(codeGen);
+        }
+        llvm::errs() << "note: " << astPath
+                     << " is missing, stale or damaged; compiling from source\n";
+    }
+    if (EmitAST && StreamStmts) {
+        llvm::errs() << "-emit-ast needs the whole program and cannot be combined with -stream\n";
+        return -1;
+    }
+
     Lexer lex(mgr, diag);
+    lex.SetThreadCount(LexThreads ? LexThreads : std::thread::hardware_concurrency());
     Token tok;
     // lex.Run(tok);
-    Sema sema(diag);
+    ASTContext astContext;
+    Sema sema(diag, astContext);
+    sema.SetExprSharing(ShareExprs);
     Parser parser(lex, sema);
-    std::shared_ptr<Program> program = parser.ParserProgram();
-    // PrintVisitor printVisitor(program);
-    CodeGen codeGen(program);
+    if (StreamStmts) {
+        CodeGen codeGen;
+        codeGen.SetDirectSSA(DirectSSA);
+        codeGen.BeginMain();
+        while (!parser.IsAtEof()) {
+            if (ASTNode *stmt = parser.ParserTopLevelStmt()) {
+                codeGen.EmitStmt(stmt);
+            }
+            astContext.Reset();
+            sema.ForgetSharedExprs();
+            codeGen.ForgetSharedValues();
+        }
+        codeGen.FinishMain();
+        return EmitModule(codeGen);
+    }
 
-    return 0;
+    Program *program = parser.ParserProgram();
+    if (EmitAST) {
+        FlatAST flat(program, source, astContext.GetTypes());
+        if (std::error_code ec = flat.Save(astPath, source)) {
+            llvm::errs() << "can't write file: " << astPath << ": " << ec.message() << "\n";
+            return -1;
+        }
+    }
+    // PrintVisitor printVisitor(program);
+    CodeGen codeGen;
+    codeGen.SetDirectSSA(DirectSSA);
+    codeGen.VisitProgram(program);
+    return EmitModule(codeGen);
 }
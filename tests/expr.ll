@@ -8,9 +8,13 @@ declare i32 @printf(ptr, ...)
 define i32 @main() {
 entry:
   %a = alloca i32, align 4
+  %b = alloca i32, align 4
+  %c = alloca i32, align 4
+  %d = alloca i32, align 4
+  %e = alloca i32, align 4
+  %f = alloca i32, align 4
   store i32 0, ptr %a, align 4
   %a1 = load i32, ptr %a, align 4
-  %b = alloca i32, align 4
   store i32 2, ptr %b, align 4
   %b2 = load i32, ptr %b, align 4
   br label %cond
@@ -39,14 +43,10 @@ else:                                             ; preds = %cond
   br label %last
 
 last:                                             ; preds = %else, %last11
-  %c = alloca i32, align 4
-  %d = alloca i32, align 4
   store i32 2, ptr %d, align 4
   %d18 = load i32, ptr %d, align 4
-  %e = alloca i32, align 4
   store i32 3, ptr %e, align 4
   %e19 = load i32, ptr %e, align 4
-  %f = alloca i32, align 4
   store i32 4, ptr %f, align 4
   %f20 = load i32, ptr %f, align 4
   store i32 2, ptr %e, align 4
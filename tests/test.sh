@@ -1,2 +1,8 @@
 ../bin/CC_LLVM ./expr.txt > ./expr.ll
-/home/zax/third-project/llvm-20/llvm-install-dir/bin/lli ./expr.ll
\ No newline at end of file
+/home/zax/third-project/llvm-20/llvm-install-dir/bin/lli ./expr.ll
+../bin/CC_LLVM -c ./expr.txt -o ./expr.o
+cc ./expr.o -o ./expr && ./expr
+../bin/CC_LLVM -run ./expr.txt
+printf 'int a = 2;\na * 21;\n' | ../bin/CC_LLVM -repl
+../bin/CC_LLVM -run ./decl.txt > ./decl.out
+../bin/CC_LLVM -run -ssa ./decl.txt | cmp - ./decl.out && echo "decl.txt: -ssa agrees"
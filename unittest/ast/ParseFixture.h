@@ -0,0 +1,27 @@
+#pragma once
+#ifndef _PARSE_FIXTURE_H_
+#define _PARSE_FIXTURE_H_
+
+#include "Parser.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <gtest/gtest.h>
+
+/// @brief Test fixture that parses source text into a `Program` with a single `Sema`.
+/// @details The AST and the types live in `astContext` until the test ends.
+class ParseFixture : public ::testing::Test {
+  public:
+    llvm::SourceMgr mgr;
+    Diagnostics diager{mgr};
+    ASTContext astContext;
+    Sema sema{diager, astContext};
+
+  public:
+    Program *Parse(llvm::StringRef src) {
+        mgr.AddNewSourceBuffer(llvm::MemoryBuffer::getMemBuffer(src, "test"), llvm::SMLoc());
+        Lexer lexer(mgr, diager);
+        Parser parser(lexer, sema);
+        return parser.ParserProgram();
+    }
+};
+
+#endif // _PARSE_FIXTURE_H_
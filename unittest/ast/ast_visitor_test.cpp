@@ -0,0 +1,64 @@
+#include "ASTVisitor.h"
+#include "ParseFixture.h"
+#include <type_traits>
+
+static_assert(!std::is_polymorphic<ASTNode>::value, "AST nodes must not carry a vtable");
+
+/// @brief Evaluates constant expressions; returns its own type instead of `llvm::Value *`.
+class ConstEvaluator : public ASTVisitor<ConstEvaluator, long> {
+  public:
+    long VisitNumberExpr(NumberExpr *numberExpr) {
+        return numberExpr->value;
+    }
+
+    long VisitBinaryExpr(BinaryExpr *binaryExpr) {
+        long left  = Visit(binaryExpr->leftExpr);
+        long right = Visit(binaryExpr->rightExpr);
+        switch (binaryExpr->op) {
+        case OpCode::Add:
+            return left + right;
+        case OpCode::Sub:
+            return left - right;
+        case OpCode::Mul:
+            return left * right;
+        case OpCode::Div:
+            return left / right;
+        }
+        return 0;
+    }
+};
+
+/// @brief Handles nothing itself, so every node reaches the `VisitNode` fallback.
+class FallbackCounter : public ASTVisitor<FallbackCounter> {
+  public:
+    unsigned count = 0;
+
+    void VisitNode(ASTNode *) {
+        count++;
+    }
+};
+
+using ASTVisitorTest = ParseFixture;
+
+TEST_F(ASTVisitorTest, DispatchesOnNodeKind) {
+    Program *program = Parse("(1 + 2) * 7 - 8 / 4;\n3 - 2 - 1;\n");
+    ASSERT_EQ(program->stmts.size(), 2u);
+
+    ConstEvaluator evaluator;
+    EXPECT_EQ(evaluator.Visit(program->stmts[0]), 19);
+    EXPECT_EQ(evaluator.Visit(program->stmts[1]), 0);
+}
+
+TEST_F(ASTVisitorTest, FallsBackToVisitNode) {
+    Program *program = Parse("int a = 1;\nif (a) a = 2;\n{ a; }\n");
+    ASSERT_EQ(program->stmts.size(), 3u);
+
+    FallbackCounter counter;
+    for (ASTNode *stmt : program->stmts) {
+        counter.Visit(stmt);
+    }
+    EXPECT_EQ(counter.count, 3u);
+
+    ConstEvaluator evaluator;
+    EXPECT_EQ(evaluator.Visit(program->stmts[1]), 0);
+}
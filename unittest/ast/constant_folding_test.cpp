@@ -0,0 +1,54 @@
+#include "ParseFixture.h"
+#include <climits>
+
+class ConstantFoldingTest : public ParseFixture {
+  public:
+    /// @brief Returns the value `stmt` folded to, or -1 when it is not a number
+    static int FoldedValue(ASTNode *stmt) {
+        auto number = llvm::dyn_cast<NumberExpr>(stmt);
+        return number ? number->value : -1;
+    }
+};
+
+TEST_F(ConstantFoldingTest, FoldsConstantSubtrees) {
+    Program *program = Parse("int a;\n"
+                             "(1 + 2) * 3;\n"
+                             "7 / 2 - 10;\n"
+                             "a + 2 * 3;\n"
+                             "2147483647 + 1;\n"
+                             "1 / 0;\n");
+    ASSERT_EQ(program->stmts.size(), 6u);
+    EXPECT_EQ(FoldedValue(program->stmts[1]), 9);
+    EXPECT_EQ(FoldedValue(program->stmts[2]), -7);
+
+    auto partial = llvm::cast<BinaryExpr>(program->stmts[3]);
+    EXPECT_TRUE(llvm::isa<VariableAssessExpr>(partial->leftExpr));
+    EXPECT_EQ(FoldedValue(partial->rightExpr), 6);
+
+    // Signed overflow is reported and wraps; a division by zero is reported and left alone.
+    EXPECT_EQ(FoldedValue(program->stmts[4]), INT_MIN);
+    EXPECT_TRUE(llvm::isa<BinaryExpr>(program->stmts[5]));
+}
+
+TEST_F(ConstantFoldingTest, PrunesConstantIfStmts) {
+    Program *program = Parse("int a;\n"
+                             "if (2 - 2) { a = 1; } else { a = 2; }\n"
+                             "if (0) { a = 3; }\n"
+                             "if (a) { a = 4; }\n"
+                             "if (1) a = 5;\n");
+    ASSERT_EQ(program->stmts.size(), 5u);
+
+    // Only the taken branch is left, and nothing of an if-statement whose branch is not taken.
+    auto taken = llvm::cast<BlockStmts>(program->stmts[1]);
+    ASSERT_EQ(taken->nodeVec.size(), 1u);
+    auto assign = llvm::cast<AssignExpr>(taken->nodeVec[0]);
+    EXPECT_EQ(FoldedValue(assign->rightExpr), 2);
+
+    EXPECT_TRUE(llvm::cast<BlockStmts>(program->stmts[2])->nodeVec.empty());
+    EXPECT_TRUE(llvm::isa<IfStmt>(program->stmts[3]));
+
+    // A branch that is not a block is wrapped in one, so it is still not an expression statement.
+    auto wrapped = llvm::cast<BlockStmts>(program->stmts[4]);
+    ASSERT_EQ(wrapped->nodeVec.size(), 1u);
+    EXPECT_TRUE(llvm::isa<AssignExpr>(wrapped->nodeVec[0]));
+}
@@ -0,0 +1,46 @@
+#include "ParseFixture.h"
+
+class ExprSharingTest : public ParseFixture {
+  public:
+    Program *Parse(llvm::StringRef src, bool shareExprs) {
+        sema.SetExprSharing(shareExprs);
+        return ParseFixture::Parse(src);
+    }
+
+    /// @brief Returns the right-hand side of the assignment statement `stmt`
+    static ASTNode *AssignedValue(ASTNode *stmt) {
+        return llvm::cast<AssignExpr>(stmt)->rightExpr;
+    }
+};
+
+TEST_F(ExprSharingTest, SharesPureExprsBetweenWrites) {
+    Program *program = Parse("int a, b = 2;\n"
+                             "a = (1 + b) * 3;\n"
+                             "a = (1 + b) * 3;\n"
+                             "b = 4;\n"
+                             "a = (1 + b) * 3;\n",
+                             true);
+    ASSERT_EQ(program->stmts.size(), 5u);
+
+    ASTNode *first  = AssignedValue(program->stmts[1]);
+    ASTNode *second = AssignedValue(program->stmts[2]);
+    ASTNode *third  = AssignedValue(program->stmts[4]);
+    EXPECT_EQ(first, second);
+    EXPECT_TRUE(first->isShared);
+
+    // `b` was written in between, so its read and everything built on it is new; the literals are
+    // still shared.
+    EXPECT_NE(first, third);
+    EXPECT_FALSE(third->isShared);
+    auto firstMul = llvm::cast<BinaryExpr>(first);
+    auto thirdMul = llvm::cast<BinaryExpr>(third);
+    EXPECT_NE(firstMul->leftExpr, thirdMul->leftExpr);
+    EXPECT_EQ(firstMul->rightExpr, thirdMul->rightExpr);
+}
+
+TEST_F(ExprSharingTest, NoSharingWhenDisabled) {
+    Program *program = Parse("int b = 2;\nb + 1;\nb + 1;\n", false);
+    ASSERT_EQ(program->stmts.size(), 3u);
+    EXPECT_NE(program->stmts[1], program->stmts[2]);
+    EXPECT_FALSE(program->stmts[1]->isShared);
+}
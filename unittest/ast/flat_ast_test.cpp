@@ -0,0 +1,79 @@
+#include "FlatAST.h"
+#include "ParseFixture.h"
+#include "llvm/Support/FileSystem.h"
+
+class FlatASTTest : public ParseFixture {
+  public:
+    llvm::SmallString<128> astPath;
+
+  public:
+    void SetUp() override {
+        ASSERT_FALSE(llvm::sys::fs::createTemporaryFile("flat_ast_test", "ast", astPath));
+    }
+
+    void TearDown() override {
+        llvm::sys::fs::remove(astPath);
+    }
+};
+
+/// @brief int a = 1; if (a) { a = a * 3; } else a = 2; a + 40;
+TEST_F(FlatASTTest, SaveAndLoad) {
+    llvm::StringRef src = "int a = 1;\nif (a) { a = a * 3; } else a = 2;\na + 40;\n";
+    FlatAST flat(Parse(src), src, astContext.GetTypes());
+    ASSERT_EQ(flat.GetStmts().size(), 3u);
+    ASSERT_FALSE(flat.Save(astPath, src));
+
+    std::unique_ptr<FlatAST> loaded = FlatAST::Load(astPath, src, astContext.GetTypes());
+    ASSERT_TRUE(loaded);
+    ASSERT_EQ(loaded->GetNodeCount(), flat.GetNodeCount());
+    EXPECT_EQ(loaded->GetStmts(), flat.GetStmts());
+    for (FlatAST::NodeId id = 0; id < flat.GetNodeCount(); id++) {
+        EXPECT_EQ(loaded->GetKind(id), flat.GetKind(id));
+        EXPECT_EQ(loaded->GetType(id), flat.GetType(id));
+        EXPECT_EQ(loaded->GetData(id), flat.GetData(id));
+        EXPECT_EQ(loaded->GetChildren(id), flat.GetChildren(id));
+        EXPECT_EQ(loaded->GetSpelling(id), flat.GetSpelling(id));
+    }
+
+    // The last statement is `a + 40`.
+    FlatAST::NodeId add = loaded->GetStmts()[2];
+    ASSERT_EQ(loaded->GetKind(add), ASTNode::ND_BinaryExpr);
+    EXPECT_EQ(loaded->GetData(add), static_cast<int>(OpCode::Add));
+    llvm::ArrayRef<FlatAST::NodeId> operands = loaded->GetChildren(add);
+    ASSERT_EQ(operands.size(), 2u);
+    EXPECT_EQ(loaded->GetSpelling(operands[0]), "a");
+    EXPECT_EQ(loaded->GetType(operands[0]), astContext.GetTypes().GetIntTy());
+    EXPECT_EQ(loaded->GetData(operands[1]), 40);
+}
+
+TEST_F(FlatASTTest, RejectsStaleFile) {
+    llvm::StringRef src = "int a = 1;\na = a + 1;\n";
+    FlatAST flat(Parse(src), src, astContext.GetTypes());
+    ASSERT_FALSE(flat.Save(astPath, src));
+
+    EXPECT_FALSE(FlatAST::Load(astPath, "int a = 1;\na = a + 2;\n", astContext.GetTypes()));
+    EXPECT_FALSE(FlatAST::Load((astPath + ".missing").str(), src, astContext.GetTypes()));
+    EXPECT_TRUE(FlatAST::Load(astPath, src, astContext.GetTypes()));
+}
+
+TEST_F(FlatASTTest, RejectsWrongChildCount) {
+    llvm::StringRef src = "int a = 1;\na + 40;\n";
+    FlatAST flat(Parse(src), src, astContext.GetTypes());
+    ASSERT_FALSE(flat.Save(astPath, src));
+    FlatAST::NodeId add = flat.GetStmts()[1];
+    ASSERT_EQ(flat.GetKind(add), ASTNode::ND_BinaryExpr);
+
+    // Turn `a + 40` into a number that still has two children. The kinds column, one byte per
+    // node, directly follows the 48-byte file header.
+    auto buffer = llvm::MemoryBuffer::getFile(astPath);
+    ASSERT_TRUE(buffer);
+    std::string bytes = (*buffer)->getBuffer().str();
+    bytes[48 + add]   = ASTNode::ND_NumberExpr;
+    std::error_code ec;
+    {
+        llvm::raw_fd_ostream os(astPath, ec);
+        ASSERT_FALSE(ec);
+        os << bytes;
+    }
+    EXPECT_FALSE(FlatAST::Load(astPath, src, astContext.GetTypes()));
+}
@@ -0,0 +1,56 @@
+#include "ParseFixture.h"
+
+using SymbolResolutionTest = ParseFixture;
+
+TEST_F(SymbolResolutionTest, ShadowedNamesGetTheirOwnSymbol) {
+    Program *program = Parse("int a = 1;\n"
+                             "{ int a = 2; a = 3; }\n"
+                             "a;\n");
+    ASSERT_EQ(program->stmts.size(), 3u);
+
+    // int a = 1;  ->  DeclStmts(VariableDecl, AssignExpr)
+    auto outerDecls = llvm::cast<DeclStmts>(program->stmts[0]);
+    auto outerDecl  = llvm::cast<VariableDecl>(outerDecls->nodeVec[0]);
+    auto outerInit  = llvm::cast<AssignExpr>(outerDecls->nodeVec[1]);
+    ASSERT_NE(outerDecl->symbol, nullptr);
+    EXPECT_EQ(outerInit->symbol, outerDecl->symbol);
+
+    auto block      = llvm::cast<BlockStmts>(program->stmts[1]);
+    auto innerDecls = llvm::cast<DeclStmts>(block->nodeVec[0]);
+    auto innerDecl  = llvm::cast<VariableDecl>(innerDecls->nodeVec[0]);
+    auto innerWrite = llvm::cast<AssignExpr>(block->nodeVec[1]);
+    EXPECT_NE(innerDecl->symbol, outerDecl->symbol);
+    EXPECT_NE(innerDecl->symbol->GetSlot(), outerDecl->symbol->GetSlot());
+    EXPECT_EQ(innerWrite->symbol, innerDecl->symbol);
+    EXPECT_EQ(llvm::cast<VariableAssessExpr>(innerWrite->leftExpr)->symbol, innerDecl->symbol);
+
+    auto outerRead = llvm::cast<VariableAssessExpr>(program->stmts[2]);
+    EXPECT_EQ(outerRead->symbol, outerDecl->symbol);
+}
+
+TEST_F(SymbolResolutionTest, DeeplyNestedStmtsDoNotRecurse) {
+    // Deep enough to overflow the stack if statements were parsed by recursion.
+    constexpr size_t DEPTH = 100000;
+    std::string src;
+    for (size_t i = 0; i < DEPTH; i++) {
+        src += "{ int a; if (a) ";
+    }
+    src += "a;";
+    for (size_t i = 0; i < DEPTH; i++) {
+        src += " else a = 1; }";
+    }
+    Program *program = Parse(src);
+    ASSERT_EQ(program->stmts.size(), 1u);
+
+    // Every block declares its own `a`; the innermost read sees the innermost one.
+    ASTNode *stmt = program->stmts[0];
+    Symbol *decl  = nullptr;
+    for (size_t i = 0; i < DEPTH; i++) {
+        auto block = llvm::cast<BlockStmts>(stmt);
+        ASSERT_EQ(block->nodeVec.size(), 2u);
+        auto decls = llvm::cast<DeclStmts>(block->nodeVec[0]);
+        decl       = llvm::cast<VariableDecl>(decls->nodeVec[0])->symbol;
+        stmt       = llvm::cast<IfStmt>(block->nodeVec[1])->thenStmt;
+    }
+    EXPECT_EQ(llvm::cast<VariableAssessExpr>(stmt)->symbol, decl);
+}
@@ -0,0 +1,85 @@
+#include "ParseFixture.h"
+
+class TypeSpecifierTest : public ParseFixture {
+  public:
+    /// @brief Returns the type of the variable declared first by `stmt`
+    static CType *DeclaredType(ASTNode *stmt) {
+        return llvm::cast<DeclStmts>(stmt)->nodeVec[0]->cType;
+    }
+
+    CType *Get(CTypeKind kind) {
+        return astContext.GetTypes().GetIntegerType(kind);
+    }
+};
+
+TEST_F(TypeSpecifierTest, Combinations) {
+    Program *program = Parse("char a;\n"
+                             "unsigned char b;\n"
+                             "short int c;\n"
+                             "long unsigned long d;\n"
+                             "signed e;\n"
+                             "unsigned f;\n"
+                             "long g;\n");
+    ASSERT_EQ(program->stmts.size(), 7u);
+    EXPECT_EQ(DeclaredType(program->stmts[0]), Get(CTypeKind::Char));
+    EXPECT_EQ(DeclaredType(program->stmts[1]), Get(CTypeKind::UChar));
+    EXPECT_EQ(DeclaredType(program->stmts[2]), Get(CTypeKind::Short));
+    EXPECT_EQ(DeclaredType(program->stmts[3]), Get(CTypeKind::ULongLong));
+    EXPECT_EQ(DeclaredType(program->stmts[4]), Get(CTypeKind::Int));
+    EXPECT_EQ(DeclaredType(program->stmts[5]), Get(CTypeKind::UInt));
+    EXPECT_EQ(DeclaredType(program->stmts[6]), Get(CTypeKind::Long));
+}
+
+TEST_F(TypeSpecifierTest, ExpressionTypes) {
+    Program *program = Parse("char c;\n"
+                             "unsigned u;\n"
+                             "long l;\n"
+                             "c + c;\n"
+                             "c + u;\n"
+                             "u * l;\n"
+                             "c = l;\n");
+    ASSERT_EQ(program->stmts.size(), 7u);
+    EXPECT_EQ(program->stmts[3]->cType, Get(CTypeKind::Int));
+    EXPECT_EQ(program->stmts[4]->cType, Get(CTypeKind::UInt));
+    EXPECT_EQ(program->stmts[5]->cType, Get(CTypeKind::Long));
+    EXPECT_EQ(program->stmts[6]->cType, Get(CTypeKind::Char));
+}
+
+TEST_F(TypeSpecifierTest, RejectsInvalidCombinations) {
+    EXPECT_DEATH(Parse("short long a;\n"), "cannot combine 'long'");
+    EXPECT_DEATH(Parse("signed unsigned a;\n"), "cannot combine 'unsigned'");
+    EXPECT_DEATH(Parse("long long long a;\n"), "cannot combine 'long'");
+}
+
+TEST_F(TypeSpecifierTest, LiteralTypes) {
+    Program *program = Parse("2147483647;\n"
+                             "2147483648;\n"
+                             "9223372036854775807;\n"
+                             "4294967295u;\n"
+                             "4294967296U;\n"
+                             "18446744073709551615ull;\n"
+                             "1l;\n"
+                             "1LL;\n"
+                             "1lu;\n");
+    ASSERT_EQ(program->stmts.size(), 9u);
+    EXPECT_EQ(program->stmts[0]->cType, Get(CTypeKind::Int));
+    EXPECT_EQ(program->stmts[1]->cType, Get(CTypeKind::Long));
+    EXPECT_EQ(program->stmts[2]->cType, Get(CTypeKind::Long));
+    EXPECT_EQ(program->stmts[3]->cType, Get(CTypeKind::UInt));
+    EXPECT_EQ(program->stmts[4]->cType, Get(CTypeKind::ULong));
+    EXPECT_EQ(program->stmts[5]->cType, Get(CTypeKind::ULongLong));
+    EXPECT_EQ(program->stmts[6]->cType, Get(CTypeKind::Long));
+    EXPECT_EQ(program->stmts[7]->cType, Get(CTypeKind::LongLong));
+    EXPECT_EQ(program->stmts[8]->cType, Get(CTypeKind::ULong));
+    EXPECT_EQ(llvm::cast<NumberExpr>(program->stmts[1])->value, 2147483648);
+    EXPECT_EQ(static_cast<uint64_t>(llvm::cast<NumberExpr>(program->stmts[5])->value),
+              UINT64_MAX);
+}
+
+TEST_F(TypeSpecifierTest, RejectsInvalidLiterals) {
+    EXPECT_DEATH(Parse("9223372036854775808;\n"), "too large to be represented in 'long long'");
+    EXPECT_DEATH(Parse("18446744073709551616u;\n"),
+                 "too large to be represented in 'unsigned long long'");
+    EXPECT_DEATH(Parse("1lL;\n"), "invalid suffix 'lL'");
+    EXPECT_DEATH(Parse("1abc;\n"), "invalid suffix 'abc'");
+}
@@ -1,22 +1,29 @@
 #include "Lexer.h"
+#include "TokenStream.h"
 #include <gtest/gtest.h>
 
+struct ExpectedToken {
+    TokenType tokenTy;
+    unsigned row;
+    unsigned col;
+};
+
 class LexerTest : public ::testing::Test {
   public:
-    Lexer *lexer;
+    Lexer *lexer = nullptr;
+    llvm::SourceMgr mgr;
+    Diagnostics diager{mgr};
 
   public:
     void SetUp() override {
-        static llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> buf =
-            llvm::MemoryBuffer::getFile("/home/zax/project/CC_LLVM/unittest/testset/lexer_01.cpp");
+        llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> buf =
+            llvm::MemoryBuffer::getFile(TESTSET_DIR "/lexer_01.cpp");
 
         if (!buf) {
             llvm::errs() << "can't open file.\n";
             return;
         }
 
-        llvm::SourceMgr mgr;
-        Diagnostics diager(mgr);
         mgr.AddNewSourceBuffer(std::move(*buf), llvm::SMLoc());
 
         lexer = new Lexer(mgr, diager);
@@ -30,18 +37,19 @@ class LexerTest : public ::testing::Test {
 /// @brief test NextToken for Lexer
 /// @details int aa, b = 4; aa = 1;
 TEST_F(LexerTest, NextToken) {
-    std::vector<Token> expectedVec, curVec;
-    expectedVec.push_back(Token{TokenType::KW_int, 1, 1});
-    expectedVec.push_back(Token{TokenType::Identifier, 1, 5});
-    expectedVec.push_back(Token{TokenType::Comma, 1, 7});
-    expectedVec.push_back(Token{TokenType::Identifier, 1, 9});
-    expectedVec.push_back(Token{TokenType::Equal, 1, 11});
-    expectedVec.push_back(Token{TokenType::Number, 1, 13});
-    expectedVec.push_back(Token{TokenType::Semi, 1, 14});
-    expectedVec.push_back(Token{TokenType::Identifier, 2, 1});
-    expectedVec.push_back(Token{TokenType::Equal, 2, 4});
-    expectedVec.push_back(Token{TokenType::Number, 2, 6});
-    expectedVec.push_back(Token{TokenType::Semi, 2, 7});
+    std::vector<ExpectedToken> expectedVec;
+    std::vector<Token> curVec;
+    expectedVec.push_back(ExpectedToken{TokenType::KW_int, 1, 1});
+    expectedVec.push_back(ExpectedToken{TokenType::Identifier, 1, 5});
+    expectedVec.push_back(ExpectedToken{TokenType::Comma, 1, 7});
+    expectedVec.push_back(ExpectedToken{TokenType::Identifier, 1, 9});
+    expectedVec.push_back(ExpectedToken{TokenType::Equal, 1, 11});
+    expectedVec.push_back(ExpectedToken{TokenType::Number, 1, 13});
+    expectedVec.push_back(ExpectedToken{TokenType::Semi, 1, 14});
+    expectedVec.push_back(ExpectedToken{TokenType::Identifier, 2, 1});
+    expectedVec.push_back(ExpectedToken{TokenType::Equal, 2, 4});
+    expectedVec.push_back(ExpectedToken{TokenType::Number, 2, 6});
+    expectedVec.push_back(ExpectedToken{TokenType::Semi, 2, 7});
 
     Token tok;
     while (true) {
@@ -53,11 +61,150 @@ TEST_F(LexerTest, NextToken) {
     }
     ASSERT_EQ(expectedVec.size(), curVec.size());
 
-    for (int i = 0; i < expectedVec.size(); i++) {
-        auto &exceptdTok = expectedVec[0];
-        auto &currTok    = curVec[0];
+    for (size_t i = 0; i < expectedVec.size(); i++) {
+        auto &exceptdTok = expectedVec[i];
+        auto &currTok    = curVec[i];
         EXPECT_EQ(exceptdTok.tokenTy, currTok.tokenTy);
-        EXPECT_EQ(exceptdTok.row, currTok.row);
-        EXPECT_EQ(exceptdTok.col, currTok.col);
+        EXPECT_EQ(exceptdTok.row, currTok.GetRowCol(diager).first);
+        EXPECT_EQ(exceptdTok.col, currTok.GetRowCol(diager).second);
+    }
+}
+
+/// @brief test NextToken on runs longer than one SIMD block
+/// @details blanks, identifiers and numbers that straddle 16/32-byte boundaries and newlines
+TEST(LexerLongRunTest, NextToken) {
+    std::string ident(45, 'x');
+    std::string number(20, '7');
+    std::string src = std::string(37, ' ') + ident + " \r\n\n" + std::string(50, ' ') + "\n" +
+                      std::string(33, ' ') + number + "+" + ident + "_" + "\n\n\n;";
+
+    llvm::SourceMgr mgr;
+    Diagnostics diager(mgr);
+    mgr.AddNewSourceBuffer(llvm::MemoryBuffer::getMemBuffer(src), llvm::SMLoc());
+    Lexer lexer(mgr, diager);
+
+    std::vector<ExpectedToken> expectedVec;
+    expectedVec.push_back(ExpectedToken{TokenType::Identifier, 1, 38});
+    expectedVec.push_back(ExpectedToken{TokenType::Number, 4, 34});
+    expectedVec.push_back(ExpectedToken{TokenType::Plus, 4, 54});
+    expectedVec.push_back(ExpectedToken{TokenType::Identifier, 4, 55});
+    expectedVec.push_back(ExpectedToken{TokenType::Semi, 7, 1});
+    expectedVec.push_back(ExpectedToken{TokenType::Eof, 7, 2});
+
+    Token tok;
+    for (auto &exceptdTok : expectedVec) {
+        lexer.NextToken(tok);
+        EXPECT_EQ(exceptdTok.tokenTy, tok.tokenTy);
+        EXPECT_EQ(exceptdTok.row, tok.GetRowCol(diager).first);
+        EXPECT_EQ(exceptdTok.col, tok.GetRowCol(diager).second);
+    }
+}
+
+/// @brief test Peek/Next for TokenStream
+/// @details int aa, b = 4; aa = 1;
+TEST_F(LexerTest, TokenStreamPeek) {
+    TokenStream stream(*lexer);
+    EXPECT_EQ(stream.Peek(7).tokenTy, TokenType::Identifier);
+    EXPECT_EQ(stream.Peek(8).tokenTy, TokenType::Equal);
+    EXPECT_EQ(stream.Peek(0).tokenTy, TokenType::KW_int);
+
+    Token tok = stream.Next();
+    EXPECT_EQ(tok.tokenTy, TokenType::KW_int);
+    EXPECT_EQ(tok.GetRowCol(diager), std::make_pair(1u, 1u));
+    EXPECT_EQ(stream.Peek(0).tokenTy, TokenType::Identifier);
+    EXPECT_EQ(stream.Peek(6).tokenTy, TokenType::Identifier);
+    EXPECT_EQ(stream.Peek(6).GetRowCol(diager).first, 2u);
+
+    EXPECT_EQ(stream.Peek(10).tokenTy, TokenType::Eof);
+    EXPECT_EQ(stream.Peek(100).tokenTy, TokenType::Eof);
+    for (int i = 0; i < 10; i++) {
+        stream.Next();
+    }
+    EXPECT_EQ(stream.Next().tokenTy, TokenType::Eof);
+    EXPECT_EQ(stream.Next().tokenTy, TokenType::Eof);
+}
+
+/// @brief test the spelling-derived values of Token
+TEST_F(LexerTest, TokenSpelling) {
+    EXPECT_EQ(sizeof(Token), 16u);
+
+    std::vector<Token> tokens;
+    Token tok;
+    do {
+        lexer->NextToken(tok);
+        tokens.push_back(tok);
+    } while (tok.tokenTy != TokenType::Eof);
+
+    EXPECT_EQ(tokens[1].GetText(), "aa");
+    uint64_t value = 0;
+    EXPECT_TRUE(tokens[5].GetValue(value));
+    EXPECT_EQ(value, 4u);
+    EXPECT_TRUE(tokens[9].GetValue(value));
+    EXPECT_EQ(value, 1u);
+    EXPECT_EQ(tokens[9].GetSuffix(), "");
+    EXPECT_EQ(tokens.back().length, 0);
+}
+
+/// @brief test that identifiers are interned into dense ids
+TEST_F(LexerTest, IdentifierInterning) {
+    std::vector<Token> tokens;
+    Token tok;
+    do {
+        lexer->NextToken(tok);
+        tokens.push_back(tok);
+    } while (tok.tokenTy != TokenType::Eof);
+
+    IdentifierTable &identifiers = lexer->GetIdentifierTable();
+    EXPECT_EQ(tokens[0].identId, IdentifierTable::NO_IDENT); ///< int
+    EXPECT_EQ(tokens[5].identId, IdentifierTable::NO_IDENT); ///< 4
+    EXPECT_EQ(tokens[1].identId, 1u);                        ///< aa
+    EXPECT_EQ(tokens[3].identId, 2u);                        ///< b
+    EXPECT_EQ(tokens[7].identId, tokens[1].identId);
+    EXPECT_EQ(identifiers.GetName(tokens[1].identId), "aa");
+    EXPECT_EQ(identifiers.GetIdCount(), 3u);
+
+    // A lexer given a table shares its ids.
+    Lexer sharing(mgr, diager, identifiers);
+    sharing.NextToken(tok);
+    sharing.NextToken(tok);
+    EXPECT_EQ(tok.identId, tokens[1].identId);
+    EXPECT_EQ(identifiers.GetIdCount(), 3u);
+}
+
+/// @brief test LexAll against NextToken
+/// @details chunks are cut inside long blank runs, identifiers and numbers
+TEST(LexerParallelTest, LexAll) {
+    std::string src;
+    for (int i = 0; i < 2000; i++) {
+        src += "int value" + std::string(i % 7, 'x') + " = " + std::to_string(i * 7919) + ";";
+        src += std::string(i % 40, ' ') + (i % 3 ? "\n" : "\r\n");
+        src += "if (value) { value = (1 + value) * 3 - value / 2; } else value = 20;\n";
+    }
+
+    llvm::SourceMgr mgr;
+    Diagnostics diager(mgr);
+    mgr.AddNewSourceBuffer(llvm::MemoryBuffer::getMemBuffer(src), llvm::SMLoc());
+
+    std::vector<Token> expectedVec;
+    Lexer serialLexer(mgr, diager);
+    Token tok;
+    do {
+        serialLexer.NextToken(tok);
+        expectedVec.push_back(tok);
+    } while (tok.tokenTy != TokenType::Eof);
+
+    for (unsigned threads : {1u, 2u, 3u, 8u}) {
+        Lexer lexer(mgr, diager);
+        lexer.SetThreadCount(threads);
+        std::vector<Token> curVec;
+        lexer.LexAll(curVec);
+
+        ASSERT_EQ(expectedVec.size(), curVec.size());
+        for (size_t i = 0; i < expectedVec.size(); i++) {
+            EXPECT_EQ(expectedVec[i].tokenTy, curVec[i].tokenTy);
+            EXPECT_EQ(expectedVec[i].ptr, curVec[i].ptr);
+            EXPECT_EQ(expectedVec[i].length, curVec[i].length);
+            EXPECT_EQ(expectedVec[i].identId, curVec[i].identId);
+        }
     }
 }
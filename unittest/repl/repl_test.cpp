@@ -0,0 +1,36 @@
+#include "Repl.h"
+#include "llvm/IR/GlobalVariable.h"
+#include <gtest/gtest.h>
+#include <sstream>
+
+/// @brief test that a statement the JIT rejects is forgotten along with its variables
+TEST(ReplTest, ForgetsStatementThatFailsToLink) {
+    std::string error;
+    std::unique_ptr<Repl> repl = Repl::Create(0, false, error);
+    ASSERT_TRUE(repl) << error;
+
+    // Takes the name of the global of the session's first variable, "a" in slot 0, so the module
+    // declaring it can not be added.
+    JIT &jit    = repl->GetJIT();
+    auto module = std::make_unique<llvm::Module>("taken", jit.GetContext());
+    auto *intTy = llvm::Type::getInt32Ty(jit.GetContext());
+    new llvm::GlobalVariable(*module, intTy, false, llvm::GlobalValue::ExternalLinkage,
+                             llvm::ConstantInt::get(intTy, 7), "a.0");
+    ASSERT_TRUE(jit.AddModule(std::move(module), error)) << error;
+
+    std::istringstream in("int a = 1;\n"
+                          "a;\n"
+                          "int b = 2;\n"
+                          "b + 1;\n");
+    testing::internal::CaptureStdout();
+    testing::internal::CaptureStderr();
+    int result      = repl->Run(in);
+    std::string out = testing::internal::GetCapturedStdout();
+    std::string err = testing::internal::GetCapturedStderr();
+
+    EXPECT_EQ(result, -1);
+    EXPECT_NE(err.find("can't run the statement"), std::string::npos) << err;
+    EXPECT_NE(err.find("undefined symbol 'a'"), std::string::npos) << err;
+    EXPECT_NE(out.find("lastVal: 2\nlastVal: 3\n"), std::string::npos) << out;
+    EXPECT_EQ(out.find("lastVal: 7"), std::string::npos) << out;
+}
@@ -0,0 +1,101 @@
+#include "Scope.h"
+#include "TypeContext.h"
+#include <gtest/gtest.h>
+#include <string>
+
+class ScopeTest : public ::testing::Test {
+  protected:
+    Symbol *Add(llvm::StringRef name) {
+        IdentId id = identifiers.Intern(name);
+        return scope.AddSymbol(id, identifiers.GetName(id), SymbolKind::LocalVariable,
+                               types.GetIntTy());
+    }
+
+    Symbol *Find(llvm::StringRef name) {
+        return scope.FindVarSymbol(identifiers.Intern(name));
+    }
+
+    Symbol *FindInCurrEnv(llvm::StringRef name) {
+        return scope.FindVarSymbolInCurrEnv(identifiers.Intern(name));
+    }
+
+    IdentifierTable identifiers;
+    TypeContext types;
+    Scope scope;
+};
+
+TEST_F(ScopeTest, ShadowingAndUndo) {
+    Symbol *outerA = Add("a");
+    Symbol *outerB = Add("b");
+    EXPECT_EQ(Find("a"), outerA);
+    EXPECT_EQ(FindInCurrEnv("a"), outerA);
+
+    scope.EnterScope();
+    EXPECT_EQ(Find("a"), outerA);
+    EXPECT_EQ(FindInCurrEnv("a"), nullptr);
+
+    Symbol *innerA = Add("a");
+    Symbol *innerC = Add("c");
+    EXPECT_NE(innerA, outerA);
+    EXPECT_EQ(Find("a"), innerA);
+    EXPECT_EQ(FindInCurrEnv("a"), innerA);
+    EXPECT_EQ(Find("b"), outerB);
+    EXPECT_EQ(Find("c"), innerC);
+
+    scope.ExitScope();
+    EXPECT_EQ(Find("a"), outerA);
+    EXPECT_EQ(Find("b"), outerB);
+    EXPECT_EQ(Find("c"), nullptr);
+    EXPECT_EQ(Find("d"), nullptr);
+
+    // Symbols outlive the scope that declared them.
+    EXPECT_EQ(innerC->GetName(), "c");
+}
+
+TEST_F(ScopeTest, RollbackToCheckpoint) {
+    Symbol *outerA               = Add("a");
+    Scope::Checkpoint checkpoint = scope.GetCheckpoint();
+
+    // A statement that declared a symbol and opened two scopes, then failed.
+    Symbol *b = Add("b");
+    scope.EnterScope();
+    Add("a");
+    scope.EnterScope();
+    Add("c");
+    scope.Rollback(checkpoint);
+
+    EXPECT_EQ(Find("a"), outerA);
+    EXPECT_EQ(FindInCurrEnv("a"), outerA);
+    EXPECT_EQ(Find("b"), nullptr);
+    EXPECT_EQ(Find("c"), nullptr);
+
+    // Back in the outermost scope, where "b" can be declared again with a fresh slot.
+    Symbol *newB = Add("b");
+    EXPECT_EQ(FindInCurrEnv("b"), newB);
+    EXPECT_NE(newB->GetSlot(), b->GetSlot());
+}
+
+TEST_F(ScopeTest, SymbolNameOutlivesDeclaringBuffer) {
+    Symbol *symbol;
+    {
+        std::string name = "temporary_name";
+        symbol           = Add(name);
+    }
+    EXPECT_EQ(symbol->GetId(), identifiers.Intern("temporary_name"));
+    EXPECT_EQ(symbol->GetName(), "temporary_name");
+    EXPECT_EQ(Find("temporary_name"), symbol);
+}
+
+TEST_F(ScopeTest, DeepNesting) {
+    Symbol *outer = Add("x");
+    for (int depth = 0; depth < 10000; depth++) {
+        scope.EnterScope();
+        Add("y");
+    }
+    EXPECT_EQ(Find("x"), outer);
+    for (int depth = 0; depth < 10000; depth++) {
+        scope.ExitScope();
+    }
+    EXPECT_EQ(Find("y"), nullptr);
+    EXPECT_EQ(Find("x"), outer);
+}
@@ -0,0 +1,57 @@
+#include "TypeContext.h"
+#include <gtest/gtest.h>
+
+class TypeContextTest : public ::testing::Test {
+  protected:
+    CType *Get(CTypeKind kind) {
+        return types.GetIntegerType(kind);
+    }
+
+    TypeContext types;
+};
+
+TEST_F(TypeContextTest, IntegerTypes) {
+    EXPECT_EQ(Get(CTypeKind::Char)->GetSize(), 1u);
+    EXPECT_EQ(Get(CTypeKind::UShort)->GetSize(), 2u);
+    EXPECT_EQ(Get(CTypeKind::Int)->GetSize(), 4u);
+    EXPECT_EQ(Get(CTypeKind::ULong)->GetAlign(), 8u);
+    EXPECT_EQ(Get(CTypeKind::LongLong)->GetSize(), 8u);
+
+    EXPECT_TRUE(Get(CTypeKind::Char)->IsSigned());
+    EXPECT_FALSE(Get(CTypeKind::UInt)->IsSigned());
+    EXPECT_EQ(types.GetUnsignedType(Get(CTypeKind::Long)), Get(CTypeKind::ULong));
+    EXPECT_EQ(Get(CTypeKind::ULongLong)->GetName(), "unsigned long long");
+}
+
+TEST_F(TypeContextTest, DerivedTypesAreUniqued) {
+    CType *intTy = types.GetIntTy();
+    CType *ptrTy = types.GetPointerType(intTy);
+    EXPECT_EQ(types.GetPointerType(intTy), ptrTy);
+    EXPECT_NE(types.GetPointerType(Get(CTypeKind::Char)), ptrTy);
+    EXPECT_EQ(ptrTy->GetElementType(), intTy);
+    EXPECT_EQ(ptrTy->GetSize(), 8u);
+    EXPECT_EQ(ptrTy->GetName(), "int *");
+
+    CType *arrayTy = types.GetArrayType(Get(CTypeKind::Short), 10);
+    EXPECT_EQ(types.GetArrayType(Get(CTypeKind::Short), 10), arrayTy);
+    EXPECT_NE(types.GetArrayType(Get(CTypeKind::Short), 11), arrayTy);
+    EXPECT_EQ(arrayTy->GetSize(), 20u);
+    EXPECT_EQ(arrayTy->GetAlign(), 2u);
+    EXPECT_EQ(arrayTy->GetArraySize(), 10u);
+
+    // Types of one context are not shared with another.
+    TypeContext other;
+    EXPECT_NE(other.GetIntTy(), intTy);
+}
+
+TEST_F(TypeContextTest, UsualArithmeticConversions) {
+    CType *intTy = types.GetIntTy();
+    EXPECT_EQ(types.GetCommonType(Get(CTypeKind::Char), Get(CTypeKind::UShort)), intTy);
+    EXPECT_EQ(types.GetCommonType(intTy, Get(CTypeKind::UInt)), Get(CTypeKind::UInt));
+    EXPECT_EQ(types.GetCommonType(Get(CTypeKind::UInt), Get(CTypeKind::Long)),
+              Get(CTypeKind::Long));
+    EXPECT_EQ(types.GetCommonType(Get(CTypeKind::ULong), Get(CTypeKind::LongLong)),
+              Get(CTypeKind::ULongLong));
+    EXPECT_EQ(types.GetCommonType(Get(CTypeKind::Short), Get(CTypeKind::LongLong)),
+              Get(CTypeKind::LongLong));
+}